@@ -0,0 +1,642 @@
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Fen.hpp"
+#include "chesslib/Network.hpp"
+#include "chesslib/Perft.hpp"
+#include "chesslib/Search.hpp"
+
+void showHelp(char** argv) {
+    std::cout << "Usage: " << argv[0] << " BENCHMARK [ARGS]\n\n";
+    std::cout << "Benchmarks:\n";
+    std::cout << "\tfen - FEN parsing (batch and one by one) and serialization throughput\n";
+    std::cout << "\tsan - move serialization and parsing throughput over random games\n";
+    std::cout << "\teval - incremental against from-scratch evaluation over the positions after every legal move of random positions\n";
+    std::cout << "\tsearch - search speed in nodes per second on the reference positions\n";
+    std::cout << "\tsmp - time to depth of the parallel search on the reference positions, doubling the threads\n";
+    std::cout << "\tnnue - network evaluations per second, incremental against refreshed accumulators, on each SIMD level\n\n";
+    std::cout << "Possible argument values:\n";
+    std::cout << "\t(--positions | -p) N - number of positions (or moves) to run on, default: 100000\n";
+    std::cout << "\t(--iterations | -i) N - number of passes over the positions, default: 10\n";
+    std::cout << "\t(--depth | -d) N - depth to search to, default: 7\n";
+    std::cout << "\t--hash MB - size of the transposition table, default: 16\n";
+    std::cout << "\t(--threads | -t) N - highest number of threads to search with, default: 32\n";
+    std::cout << "\t--network FILE - network to evaluate with, default: random weights\n";
+    std::cout << "\t(--help | -h) - show this message\n\n";
+}
+
+struct BenchOptions {
+    std::size_t positions;
+    int iterations;
+    int depth;
+    std::size_t hash;
+    unsigned int threads;
+    std::string network;
+};
+
+// positions reached by random playouts from the reference positions, so that the input is not the same few boards
+std::vector<std::string> randomFENs(std::size_t count) {
+    constexpr int MAX_PLIES = 40;
+
+    std::mt19937_64 random(20240611);
+    std::vector<std::string> fens;
+
+    fens.reserve(count);
+
+    while (fens.size() < count) {
+        Game game;
+        game.parseFEN(PERFT_POSITIONS[fens.size() % PERFT_POSITIONS.size()].fen);
+
+        for (int ply = 0; ply < MAX_PLIES && fens.size() < count; ++ply) {
+            MoveList moves;
+            game.generateLegalMoves(moves);
+
+            if (moves.empty()) {
+                break;
+            }
+
+            game.makeMove(moves[random() % moves.size()]);
+            fens.push_back(game.serializeAsFEN());
+        }
+    }
+
+    return fens;
+}
+
+void printThroughput(std::string_view name, std::size_t bytes, std::size_t items, std::string_view unit, double seconds) {
+    auto megabytesPerSecond = seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0;
+    auto itemsPerSecond = seconds > 0 ? static_cast<std::uint64_t>(items / seconds) : 0;
+
+    std::cout << std::format("{:<18} {:>10.1f} MB/s {:>12} {}/sec\n", name, megabytesPerSecond, itemsPerSecond, unit);
+}
+
+int benchFEN(const BenchOptions& options) {
+    constexpr std::size_t BATCH_SIZE = 4096;
+
+    auto fens = randomFENs(options.positions);
+
+    std::string buffer;
+
+    for (const auto& fen : fens) {
+        buffer += fen;
+        buffer += '\n';
+    }
+
+    std::cout << std::format("{} positions, {} bytes\n\n", fens.size(), buffer.size());
+
+    std::vector<PackedPosition> positions(BATCH_SIZE);
+    std::size_t parsed = 0;
+    std::size_t errors = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        std::span<const char> rest(buffer);
+
+        while (!rest.empty()) {
+            auto result = parseFENBatch(rest, positions);
+
+            parsed += result.positions;
+            errors += result.errors;
+            rest = rest.subspan(result.consumed);
+        }
+    }
+
+    std::chrono::duration<double> batchElapsed = std::chrono::steady_clock::now() - start;
+
+    printThroughput("parseFENBatch", buffer.size() * options.iterations, parsed, "positions", batchElapsed.count());
+
+    Game game;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const auto& fen : fens) {
+            if (!game.parseFEN(fen).has_value()) {
+                ++errors;
+            }
+        }
+    }
+
+    std::chrono::duration<double> gameElapsed = std::chrono::steady_clock::now() - start;
+
+    printThroughput("Game::parseFEN", buffer.size() * options.iterations, fens.size() * options.iterations, "positions", gameElapsed.count());
+
+    // serialization, of all the positions parsed back into one buffer
+    std::vector<PackedPosition> allPositions(fens.size());
+    parseFENBatch(buffer, allPositions);
+
+    std::vector<char> output(allPositions.size() * (MAX_FEN_LENGTH + 1));
+    std::size_t written = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        written += serializeFENBatch(allPositions, output).written;
+    }
+
+    std::chrono::duration<double> serializeElapsed = std::chrono::steady_clock::now() - start;
+
+    printThroughput("serializeFENBatch", written, allPositions.size() * options.iterations, "positions", serializeElapsed.count());
+
+    if (std::string_view(output.data(), written / options.iterations) != buffer) {
+        std::cout << "\nSerialized positions differ from the parsed ones\n";
+
+        return 1;
+    }
+
+    if (errors > 0) {
+        std::cout << std::format("\n{} positions failed to parse\n", errors);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+// games of random moves from the start position
+std::vector<std::vector<Move>> randomGames(std::size_t moveCount) {
+    constexpr int MAX_PLIES = 120;
+
+    std::mt19937_64 random(20240611);
+    std::vector<std::vector<Move>> games;
+    std::size_t total = 0;
+
+    while (total < moveCount) {
+        Game game;
+        game.parseFEN(PERFT_POSITIONS[0].fen);
+
+        auto& moves = games.emplace_back();
+
+        for (int ply = 0; ply < MAX_PLIES && total < moveCount; ++ply) {
+            MoveList legalMoves;
+            game.generateLegalMoves(legalMoves);
+
+            if (legalMoves.empty()) {
+                break;
+            }
+
+            auto move = legalMoves[random() % legalMoves.size()];
+
+            moves.push_back(game.unpackMove(move));
+            game.makeMove(move);
+            ++total;
+        }
+    }
+
+    return games;
+}
+
+int benchSAN(const BenchOptions& options) {
+    auto games = randomGames(options.positions);
+
+    Game start;
+    start.parseFEN(PERFT_POSITIONS[0].fen);
+
+    std::size_t moveCount = 0;
+
+    for (const auto& moves : games) {
+        moveCount += moves.size();
+    }
+
+    // every game as one line of SAN, written by `serializeMoves()`
+    std::vector<char> buffer(moveCount * (MAX_MOVE_LENGTH + 1));
+    std::vector<std::string_view> lines;
+    std::size_t bytes = 0;
+    std::size_t errors = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        bytes = 0;
+        lines.clear();
+
+        for (const auto& moves : games) {
+            auto result = start.serializeMoves(moves, std::span<char>(buffer).subspan(bytes));
+
+            if (result.moves != moves.size()) {
+                ++errors;
+            }
+
+            lines.emplace_back(buffer.data() + bytes, result.written);
+            bytes += result.written;
+        }
+    }
+
+    std::chrono::duration<double> serializeElapsed = std::chrono::steady_clock::now() - startTime;
+
+    std::cout << std::format("{} games, {} moves, {} bytes\n\n", games.size(), moveCount, bytes);
+
+    printThroughput("serializeMoves", bytes * options.iterations, moveCount * options.iterations, "moves", serializeElapsed.count());
+
+    Game game;
+
+    startTime = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (auto line : lines) {
+            game.parseFEN(PERFT_POSITIONS[0].fen);
+
+            while (!line.empty()) {
+                auto end = line.find(' ');
+                auto move = game.parsePackedMove(line.substr(0, end));
+
+                if (!move.has_value()) {
+                    ++errors;
+                    break;
+                }
+
+                game.makeMove(*move);
+
+                line = (end == std::string_view::npos) ? std::string_view() : line.substr(end + 1);
+            }
+        }
+    }
+
+    std::chrono::duration<double> parseElapsed = std::chrono::steady_clock::now() - startTime;
+
+    // the replay (making the moves, loading the start position) is included, it is what reading a game takes
+    printThroughput("parsePackedMove", bytes * options.iterations, moveCount * options.iterations, "moves", parseElapsed.count());
+
+    if (errors > 0) {
+        std::cout << std::format("\n{} games failed to round-trip\n", errors);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+// how each evaluation is done after every legal move, the way a search reaches the leaves
+enum EvaluationMode {
+    NO_EVALUATION,
+    INCREMENTAL_EVALUATION,
+    FULL_EVALUATION
+};
+
+// random positions packed to be loaded into one game, and the number of legal moves from all of them
+std::pair<std::vector<PackedPosition>, std::size_t> randomPositions(std::size_t count) {
+    auto fens = randomFENs(count);
+
+    std::vector<PackedPosition> positions;
+    std::size_t moveCount = 0;
+
+    Game game;
+
+    positions.reserve(fens.size());
+
+    for (const auto& fen : fens) {
+        positions.push_back(*parseFENPosition(fen));
+        game.loadPosition(positions.back());
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        moveCount += moves.size();
+    }
+
+    return { positions, moveCount };
+}
+
+int benchEval(const BenchOptions& options) {
+    auto [positions, evaluationCount] = randomPositions(options.positions);
+
+    Game game;
+
+    std::cout << std::format("{} positions, {} evaluations per pass\n\n", positions.size(), evaluationCount);
+
+    auto run = [&](EvaluationMode mode) {
+        std::int64_t checksum = 0;
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < options.iterations; ++iteration) {
+            for (const auto& position : positions) {
+                game.loadPosition(position);
+
+                MoveList moves;
+                game.generateLegalMoves(moves);
+
+                for (auto move : moves) {
+                    game.makeMove(move);
+
+                    if (mode == INCREMENTAL_EVALUATION) {
+                        checksum += game.evaluate();
+                    }
+                    else if (mode == FULL_EVALUATION) {
+                        checksum += game.computeEvaluation();
+                    }
+
+                    game.undoMove();
+                }
+            }
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+        return std::pair{ elapsed.count(), checksum };
+    };
+
+    auto [baseSeconds, baseChecksum] = run(NO_EVALUATION);
+    auto [incrementalSeconds, incrementalChecksum] = run(INCREMENTAL_EVALUATION);
+    auto [fullSeconds, fullChecksum] = run(FULL_EVALUATION);
+
+    auto total = static_cast<double>(evaluationCount) * options.iterations;
+
+    // the loop alone (loading the positions, making and taking back the moves) is taken out of the other two,
+    // what is left is the cost of the evaluation
+    auto printLine = [&](std::string_view name, double seconds) {
+        auto evaluationSeconds = std::max(seconds - baseSeconds, 0.0);
+        auto nanoseconds = evaluationSeconds * 1e9 / total;
+
+        std::cout << std::format("{:<20} {:>8.3f} s {:>12} moves/sec {:>8.2f} ns per evaluation\n",
+            name, seconds, static_cast<std::uint64_t>(total / seconds), nanoseconds);
+    };
+
+    printLine("without evaluation", baseSeconds);
+    printLine("evaluate", incrementalSeconds);
+    printLine("computeEvaluation", fullSeconds);
+
+    if (incrementalChecksum != fullChecksum) {
+        std::cout << "\nincremental and full evaluations differ\n";
+
+        return 1;
+    }
+
+    return baseChecksum == 0 ? 0 : 1;
+}
+
+// how the accumulator is brought up to date for each evaluation after a move
+enum AccumulatorMode {
+    NO_NETWORK,
+    INCREMENTAL_ACCUMULATOR,
+    REFRESHED_ACCUMULATOR
+};
+
+int benchNNUE(const BenchOptions& options) {
+    std::unique_ptr<Network> network;
+
+    if (options.network.empty()) {
+        network = Network::random(20240611);
+    }
+    else {
+        auto loaded = Network::load(options.network);
+
+        if (!loaded) {
+            std::cout << std::format("{}: {}\n", options.network, networkErrorMessage(loaded.error()));
+
+            return 1;
+        }
+
+        network = std::move(*loaded);
+    }
+
+    auto [positions, evaluationCount] = randomPositions(options.positions);
+
+    Game game;
+
+    std::cout << std::format("{} network, {} positions, {} evaluations per pass\n\n",
+        options.network.empty() ? "random" : options.network, positions.size(), evaluationCount);
+
+    auto run = [&](AccumulatorMode mode) {
+        std::int64_t checksum = 0;
+
+        game.setNetwork(mode == NO_NETWORK ? nullptr : network.get());
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < options.iterations; ++iteration) {
+            for (const auto& position : positions) {
+                game.loadPosition(position);
+
+                MoveList moves;
+                game.generateLegalMoves(moves);
+
+                for (auto move : moves) {
+                    game.makeMove(move);
+
+                    // setting the network again drops the accumulator, the evaluation starts from the board
+                    if (mode == REFRESHED_ACCUMULATOR) {
+                        game.setNetwork(network.get());
+                    }
+
+                    if (mode != NO_NETWORK) {
+                        checksum += game.evaluateNetwork();
+                    }
+
+                    game.undoMove();
+                }
+            }
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+        return std::pair{ elapsed.count(), checksum };
+    };
+
+    auto total = static_cast<double>(evaluationCount) * options.iterations;
+    auto [baseSeconds, baseChecksum] = run(NO_NETWORK);
+
+    std::cout << std::format("{:<24} {:>8.3f} s {:>12} moves/sec\n", "without evaluation", baseSeconds,
+        static_cast<std::uint64_t>(total / baseSeconds));
+
+    // like in `eval`, the loop alone is taken out; the first evaluation after loading a position is a refresh either way
+    auto printLine = [&](std::string_view name, double seconds) {
+        auto evaluationSeconds = std::max(seconds - baseSeconds, 1e-9);
+
+        std::cout << std::format("{:<24} {:>8.3f} s {:>12} evals/sec {:>8.2f} ns per evaluation\n",
+            name, seconds, static_cast<std::uint64_t>(total / evaluationSeconds), evaluationSeconds * 1e9 / total);
+    };
+
+    std::optional<std::int64_t> expectedChecksum;
+    auto mismatch = false;
+
+    for (auto [level, name] : { std::pair{ NO_SIMD, "scalar" }, std::pair{ SSE41_SIMD, "sse4.1" }, std::pair{ AVX2_SIMD, "avx2" } }) {
+        if (!network->setSimdLevel(level)) {
+            std::cout << std::format("{:<24} not supported\n", name);
+            continue;
+        }
+
+        auto [incrementalSeconds, incrementalChecksum] = run(INCREMENTAL_ACCUMULATOR);
+        auto [refreshedSeconds, refreshedChecksum] = run(REFRESHED_ACCUMULATOR);
+
+        printLine(std::format("{} incremental", name), incrementalSeconds);
+        printLine(std::format("{} refreshed", name), refreshedSeconds);
+
+        if (!expectedChecksum) {
+            expectedChecksum = incrementalChecksum;
+        }
+
+        mismatch = mismatch || incrementalChecksum != *expectedChecksum || refreshedChecksum != *expectedChecksum;
+    }
+
+    if (mismatch) {
+        std::cout << "\nevaluations differ between the accumulators or the SIMD levels\n";
+
+        return 1;
+    }
+
+    return baseChecksum == 0 ? 0 : 1;
+}
+
+int benchSearch(const BenchOptions& options) {
+    TranspositionTable table(options.hash, true);
+    Searcher searcher(table);
+    Game game;
+
+    std::cout << std::format("{} entries in the transposition table{}\n\n", table.size(), table.usesHugePages() ? ", on huge pages" : "");
+
+    std::uint64_t totalNodes = 0;
+    std::chrono::milliseconds totalElapsed{};
+
+    for (const auto& position : PERFT_POSITIONS) {
+        game.parseFEN(position.fen);
+        table.clear();
+
+        auto result = searcher.search(game, SearchLimits{ .depth = options.depth });
+        auto hitRate = table.probes() > 0 ? 100.0 * table.hits() / table.probes() : 0.0;
+
+        totalNodes += result.nodes;
+        totalElapsed += result.elapsed;
+
+        std::cout << std::format("{:<16} depth {:>2}: {:>6} {:>12} nodes {:>10} ms {:>12} nodes/sec {:>6.1f}% hits {:>5.1f}% full\n",
+            position.name, result.depth, game.serializeMove(game.unpackMove(result.bestMove)), result.nodes,
+            result.elapsed.count(), result.nodesPerSecond, hitRate, table.fillPermille() / 10.0);
+    }
+
+    auto nodesPerSecond = totalElapsed.count() > 0 ? totalNodes * 1000 / totalElapsed.count() : 0;
+
+    std::cout << std::format("\n{} nodes in {} ms, {} nodes/sec\n", totalNodes, totalElapsed.count(), nodesPerSecond);
+
+    return 0;
+}
+
+int benchSMP(const BenchOptions& options) {
+    TranspositionTable table(options.hash, true);
+    Game game;
+
+    double singleThreadedSeconds = 0;
+
+    std::cout << std::format("time to depth {} over the reference positions, {} hardware threads\n\n", options.depth, std::thread::hardware_concurrency());
+
+    for (unsigned int threads = 1; threads <= options.threads; threads *= 2) {
+        ParallelSearcher searcher(threads, table);
+
+        std::uint64_t nodes = 0;
+        double seconds = 0;
+
+        for (const auto& position : PERFT_POSITIONS) {
+            game.parseFEN(position.fen);
+            table.clear();
+
+            // the wall clock, stopping the helpers included
+            auto startTime = std::chrono::steady_clock::now();
+            auto result = searcher.search(game, SearchLimits{ .depth = options.depth });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+            nodes += result.nodes;
+            seconds += elapsed.count();
+        }
+
+        if (threads == 1) {
+            singleThreadedSeconds = seconds;
+        }
+
+        auto nodesPerSecond = seconds > 0 ? static_cast<std::uint64_t>(nodes / seconds) : 0;
+        auto speedup = seconds > 0 ? singleThreadedSeconds / seconds : 0.0;
+
+        std::cout << std::format("{:>3} threads: {:>10.3f} s {:>12} nodes {:>12} nodes/sec {:>6.2f}x\n", threads, seconds, nodes, nodesPerSecond, speedup);
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options{ .positions = 100000, .iterations = 10, .depth = 7, .hash = 16, .threads = 32, .network = {} };
+
+    if (argc < 2) {
+        showHelp(argv);
+
+        return 1;
+    }
+
+    std::string benchmark = argv[1];
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if ((arg == "--positions" || arg == "-p") && i + 1 < argc) {
+            options.positions = static_cast<std::size_t>(std::stoul(argv[++i]));
+        }
+        else if ((arg == "--iterations" || arg == "-i") && i + 1 < argc) {
+            options.iterations = std::stoi(argv[++i]);
+        }
+        else if ((arg == "--depth" || arg == "-d") && i + 1 < argc) {
+            options.depth = std::stoi(argv[++i]);
+        }
+        else if ((arg == "--threads" || arg == "-t") && i + 1 < argc) {
+            options.threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            options.hash = static_cast<std::size_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--network" && i + 1 < argc) {
+            options.network = argv[++i];
+        }
+        else if (arg == "--help" || arg == "-h") {
+            showHelp(argv);
+
+            return 0;
+        }
+        else {
+            showHelp(argv);
+
+            return 1;
+        }
+    }
+
+    if (options.positions < 1 || options.iterations < 1 || options.depth < 1 || options.threads < 1) {
+        showHelp(argv);
+
+        return 1;
+    }
+
+    if (benchmark == "fen") {
+        return benchFEN(options);
+    }
+
+    if (benchmark == "san") {
+        return benchSAN(options);
+    }
+
+    if (benchmark == "eval") {
+        return benchEval(options);
+    }
+
+    if (benchmark == "search") {
+        return benchSearch(options);
+    }
+
+    if (benchmark == "smp") {
+        return benchSMP(options);
+    }
+
+    if (benchmark == "nnue") {
+        return benchNNUE(options);
+    }
+
+    showHelp(argv);
+
+    return benchmark == "--help" || benchmark == "-h" ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "chesslib/Bitboard.hpp"
+#include "chesslib/Piece.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// attacks of a sliding piece from a single square, looked up by the relevant blockers only;
+// the index into `attacks` is either computed with a magic multiplication or with BMI2 PEXT
+struct SlidingAttacks {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned int shift;
+
+    unsigned int index(Bitboard occupied) const;
+};
+
+extern std::array<SlidingAttacks, 64> ROOK_ATTACKS;
+extern std::array<SlidingAttacks, 64> BISHOP_ATTACKS;
+
+// attacks of a piece jumping by fixed (rank, file) offsets, skipping the offsets leading off the board
+template<std::size_t N>
+constexpr std::array<Bitboard, 64> generateLeaperAttacks(const int (&offsets)[N][2]) {
+    std::array<Bitboard, 64> attacks{};
+
+    for (int square = 0; square < 64; ++square) {
+        for (const auto& offset : offsets) {
+            int rank = square / 8 + offset[0];
+            int file = square % 8 + offset[1];
+
+            if (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                attacks[square] |= squareBit(Square::fromFileRank(file, rank));
+            }
+        }
+    }
+
+    return attacks;
+}
+
+struct LineTables {
+    std::array<std::array<Bitboard, 64>, 64> between;
+    std::array<std::array<Bitboard, 64>, 64> line;
+};
+
+constexpr LineTables generateLineTables() {
+    constexpr int directions[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+
+    LineTables tables{};
+
+    for (int from = 0; from < 64; ++from) {
+        for (const auto& direction : directions) {
+            // the whole line through `from` along this direction, both ways, edge to edge
+            Bitboard fullLine = squareBit(Square(from));
+
+            for (int sign : { 1, -1 }) {
+                int rank = from / 8 + sign * direction[0];
+                int file = from % 8 + sign * direction[1];
+
+                while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                    fullLine |= squareBit(Square::fromFileRank(file, rank));
+
+                    rank += sign * direction[0];
+                    file += sign * direction[1];
+                }
+            }
+
+            // walking away from `from`, every square reached is aligned with it and the ones walked past are in between
+            Bitboard walked = EMPTY_BITBOARD;
+            int rank = from / 8 + direction[0];
+            int file = from % 8 + direction[1];
+
+            while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                auto to = Square::fromFileRank(file, rank).index();
+
+                tables.between[from][to] = walked;
+                tables.line[from][to] = fullLine;
+
+                walked |= squareBit(Square(to));
+
+                rank += direction[0];
+                file += direction[1];
+            }
+        }
+    }
+
+    return tables;
+}
+
+inline constexpr int KNIGHT_OFFSETS[8][2] = { { 2, 1 }, { 2, -1 }, { -2, 1 }, { -2, -1 }, { 1, 2 }, { 1, -2 }, { -1, 2 }, { -1, -2 } };
+inline constexpr int KING_OFFSETS[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+inline constexpr int WHITE_PAWN_OFFSETS[2][2] = { { 1, -1 }, { 1, 1 } };
+inline constexpr int BLACK_PAWN_OFFSETS[2][2] = { { -1, -1 }, { -1, 1 } };
+
+// the tables below are generated at compile time, so they need neither initialization nor edge checks at runtime
+
+inline constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS = generateLeaperAttacks(KNIGHT_OFFSETS);
+inline constexpr std::array<Bitboard, 64> KING_ATTACKS = generateLeaperAttacks(KING_OFFSETS);
+
+// squares attacked by a pawn of the given color (`colorIndex()`) standing on a square
+inline constexpr std::array<std::array<Bitboard, 64>, 2> PAWN_ATTACKS = { generateLeaperAttacks(WHITE_PAWN_OFFSETS), generateLeaperAttacks(BLACK_PAWN_OFFSETS) };
+
+inline constexpr LineTables LINE_TABLES = generateLineTables();
+
+// squares strictly between two squares sharing a rank, file or diagonal; empty otherwise
+inline constexpr const std::array<std::array<Bitboard, 64>, 64>& BETWEEN = LINE_TABLES.between;
+
+// the whole rank, file or diagonal going through both squares (edge to edge); empty if not aligned
+inline constexpr const std::array<std::array<Bitboard, 64>, 64>& LINE = LINE_TABLES.line;
+
+// true when the tables were filled for PEXT indexing; decided once, in `initAttacks()`
+extern bool USE_PEXT;
+
+// fills the sliding attack tables; safe to call more than once, `Game` calls it on construction
+void initAttacks();
+
+// whether the CPU we are running on supports BMI2 (and hence PEXT)
+bool hasPextSupport();
+
+unsigned int pextIndex(Bitboard occupied, Bitboard mask);
+
+inline unsigned int SlidingAttacks::index(Bitboard occupied) const {
+#if defined(__BMI2__)
+    return static_cast<unsigned int>(_pext_u64(occupied, mask));
+#else
+    if (USE_PEXT) {
+        return pextIndex(occupied, mask);
+    }
+
+    return static_cast<unsigned int>(((occupied & mask) * magic) >> shift);
+#endif
+}
+
+inline Bitboard rookAttacks(Square square, Bitboard occupied) {
+    const auto& entry = ROOK_ATTACKS[square.index()];
+    return entry.attacks[entry.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(Square square, Bitboard occupied) {
+    const auto& entry = BISHOP_ATTACKS[square.index()];
+    return entry.attacks[entry.index(occupied)];
+}
+
+inline Bitboard queenAttacks(Square square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
+
+inline Bitboard knightAttacks(Square square) {
+    return KNIGHT_ATTACKS[square.index()];
+}
+
+inline Bitboard kingAttacks(Square square) {
+    return KING_ATTACKS[square.index()];
+}
+
+inline Bitboard pawnAttacks(PieceColor color, Square square) {
+    return PAWN_ATTACKS[colorIndex(color)][square.index()];
+}
+
+inline Bitboard between(Square from, Square to) {
+    return BETWEEN[from.index()][to.index()];
+}
+
+inline Bitboard line(Square from, Square to) {
+    return LINE[from.index()][to.index()];
+}
+
+// attacks of a knight, bishop, rook, queen or king, with the piece type resolved at compile time
+template<PieceType Type>
+inline Bitboard pieceAttacks(Square square, Bitboard occupied) {
+    static_assert(Type != PAWN, "pawn attacks depend on the color, use pawnAttacks()");
+
+    if constexpr (Type == KNIGHT) {
+        return knightAttacks(square);
+    }
+    else if constexpr (Type == BISHOP) {
+        return bishopAttacks(square, occupied);
+    }
+    else if constexpr (Type == ROOK) {
+        return rookAttacks(square, occupied);
+    }
+    else if constexpr (Type == QUEEN) {
+        return queenAttacks(square, occupied);
+    }
+    else {
+        return kingAttacks(square);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#include "chesslib/Square.hpp"
+
+// one bit per square, a1 = bit 0, b1 = bit 1, ..., h8 = bit 63
+using Bitboard = std::uint64_t;
+
+constexpr Bitboard EMPTY_BITBOARD = 0ULL;
+constexpr Bitboard ALL_SQUARES = ~EMPTY_BITBOARD;
+
+constexpr Bitboard squareBit(Square square) {
+    return 1ULL << square.index();
+}
+
+constexpr int popCount(Bitboard bitboard) {
+    return std::popcount(bitboard);
+}
+
+// square of the least significant set bit; undefined for an empty bitboard
+constexpr Square lsb(Bitboard bitboard) {
+    return Square(std::countr_zero(bitboard));
+}
+
+// removes the least significant set bit and returns its square
+constexpr Square popLsb(Bitboard& bitboard) {
+    auto square = Square(std::countr_zero(bitboard));
+    bitboard &= bitboard - 1;
+    return square;
+}
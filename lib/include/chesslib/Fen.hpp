@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string_view>
+
+#include "chesslib/PackedPosition.hpp"
+
+// the longest FEN `serializeFENPosition()` writes: 64 squares and 7 rank separators, the side to move, 4 castling
+// rights, the en passant square, two 5-digit counters and 5 spaces
+inline constexpr std::size_t MAX_FEN_LENGTH = 71 + 1 + 4 + 2 + 5 + 5 + 5;
+
+// the first thing wrong with a FEN string
+enum FenError {
+    MISSING_FIELD,
+    INVALID_PIECE_PLACEMENT,
+
+    // well formed, but not a position the move generator can work on: a side with more than one king, no king for the
+    // side to move, or a pawn on the first or last rank
+    INVALID_POSITION,
+    INVALID_SIDE_TO_MOVE,
+    INVALID_CASTLING_RIGHTS,
+    INVALID_EN_PASSANT_TARGET,
+    INVALID_HALFMOVE_CLOCK,
+    INVALID_FULLMOVE_NUMBER,
+    TRAILING_CHARACTERS
+};
+
+std::string_view fenErrorMessage(FenError error);
+
+// parses and validates a FEN string without allocating; the move counters may be left out (as EPD does), an en
+// passant target with no pawn which could have just skipped it is dropped, and so is a castling right whose king
+// or rook is not on its starting square
+std::expected<PackedPosition, FenError> parseFENPosition(std::string_view fen);
+
+struct FenBatchResult {
+    // positions written to the output
+    std::size_t positions;
+
+    // malformed lines, skipped
+    std::size_t errors;
+
+    // bytes of the buffer taken, always whole lines; the next batch continues from here
+    std::size_t consumed;
+};
+
+// parses newline separated FENs from the buffer into the output until either of them runs out; empty lines are skipped
+// and the last line needs no line break, so a buffer read in chunks should be cut at a line break
+FenBatchResult parseFENBatch(std::span<const char> buffer, std::span<PackedPosition> positions);
+
+// writes the FEN of the position into the buffer, without a terminating zero; returns the number of characters
+// written, or 0 (leaving the buffer alone) when the FEN does not fit
+std::size_t serializeFENPosition(const PackedPosition& position, std::span<char> buffer);
+
+struct FenSerializeResult {
+    // positions written to the buffer
+    std::size_t positions;
+
+    // bytes of the buffer filled
+    std::size_t written;
+};
+
+// writes the FENs of the positions into the buffer, each followed by a line break (the format `parseFENBatch()`
+// reads), until either of them runs out; a buffer of `MAX_FEN_LENGTH + 1` bytes per position always fits all of them
+FenSerializeResult serializeFENBatch(std::span<const PackedPosition> positions, std::span<char> buffer);
@@ -1,38 +1,31 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
-#include <deque>
+#include <expected>
 #include <format>
-#include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <ostream>
+#include <span>
 #include <iostream>
 #include <vector>
 
-enum PieceColor {
-    BLACK = 'b',
-    WHITE = 'w'
-};
-
-enum Piece {
-    NONE = 0,
-
-    WHITE_PAWN = 'P',
-    WHITE_ROOK = 'R',
-    WHITE_KNIGHT = 'N',
-    WHITE_BISHOP = 'B',
-    WHITE_QUEEN = 'Q',
-    WHITE_KING = 'K',
-
-    BLACK_PAWN = 'p',
-    BLACK_ROOK = 'r',
-    BLACK_KNIGHT = 'n',
-    BLACK_BISHOP = 'b',
-    BLACK_QUEEN = 'q',
-    BLACK_KING = 'k'
-};
-
+#include "chesslib/Bitboard.hpp"
+#include "chesslib/Evaluator.hpp"
+#include "chesslib/Network.hpp"
+#include "chesslib/Piece.hpp"
+#include "chesslib/Square.hpp"
+#include "chesslib/Fen.hpp"
+#include "chesslib/PackedPosition.hpp"
+#include "chesslib/Move.hpp"
+#include "chesslib/PackedMove.hpp"
+#include "chesslib/MoveList.hpp"
+#include "chesslib/MoveValidityTable.hpp"
+#include "chesslib/Zobrist.hpp"
+
+// the castling rights mask spelled out, for the callers which read single rights
 struct CastlingAvailability {
     bool WHITE_KING_SIDE;
     bool WHITE_QUEEN_SIDE;
@@ -41,206 +34,178 @@ struct CastlingAvailability {
     bool BLACK_QUEEN_SIDE;
 };
 
-struct Position {
-    unsigned int row;
-    char col;
-
-    void parse(const std::string& positionString) {
-        col = positionString.at(0);
-        row = static_cast<int>(positionString.at(1)) - static_cast<int>('1') + 1;
-    }
+// what `makeMove()` can not recover from the move itself; pushed on every move and popped by `undoMove()`
+struct UndoState {
+    std::uint64_t positionKey;
+    std::uint64_t pawnKey;
 
-    bool operator==(const Position& other) const = default;
+    std::uint16_t halfmoveClock;
 
-    friend std::ostream& operator<<(std::ostream& os, const Position& pos) {
-        return os << std::format("<{1}, {0}>", static_cast<char>(pos.col), pos.row);
-    }
-};
+    PackedMove move;
 
-struct Move {
-    Piece piece;
+    Piece captured;
 
-    Position from;
-    Position to;
+    // `CastlingRights` mask
+    std::uint8_t castlingRights;
 
-    std::optional<Piece> promotion;
+    std::optional<Square> enPassantTarget;
+};
 
-    bool isCapture;
-    bool isCastling;
+enum MoveNotation {
+    // standard algebraic notation, `Nbd7`, `exd8=Q+`, `O-O`
+    SAN_NOTATION,
 
-    bool operator==(const Move& other) const = default;
+    // long algebraic notation of the UCI protocol, `b8d7`, `e7d8q`, `e1g1`
+    UCI_NOTATION
 };
 
-template<>
-struct std::hash<Piece> {
-    std::size_t operator()(Piece const& p) const noexcept {
-        return std::hash<char>{}(p);
-    }
-};
+// the longest move `serializeMove()` writes, `Qh4xe1+` or `exd8=Q#`
+inline constexpr std::size_t MAX_MOVE_LENGTH = 7;
 
-template<>
-struct std::hash<Position> {
-    std::size_t operator()(Position const& pos) const noexcept {
-        std::size_t h1 = std::hash<int>{}(pos.row);
-        std::size_t h2 = std::hash<char>{}(pos.col);
-        return h1 ^ (h2 << 1);
-    }
-};
+struct MovesSerializeResult {
+    // moves written to the buffer
+    std::size_t moves;
 
-template<>
-struct std::hash<Move> {
-    std::size_t operator()(Move const& move) const noexcept {
-        std::size_t h1 = std::hash<Position>{}(move.from);
-        std::size_t h2 = std::hash<Position>{}(move.to);
-        std::size_t h3 = std::hash<Piece>{}(move.piece);
-        std::size_t h4 = std::hash<std::optional<Piece>>{}(move.promotion);
-        std::size_t h5 = std::hash<bool>{}(move.isCapture);
-        std::size_t h6 = std::hash<bool>{}(move.isCastling);
-        return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4) ^ (h6 << 5); // or use boost::hash_combine
-    }
+    // bytes of the buffer filled
+    std::size_t written;
 };
 
-struct MoveComparator {
-    bool operator()(const Move& lhs, const Move& rhs) const {
-        return std::hash<Move>{}(lhs) < std::hash<Move>{}(rhs);
-    }
+enum MoveGenerationType {
+    ALL_MOVES,
+    CAPTURE_MOVES,
+    QUIET_MOVES,
+    EVASION_MOVES
 };
 
-class PositionIterator {
+class Game {
 public:
-    PositionIterator(const Position from, const Position to) : dRow(0), dCol(0) {
-        auto beginRow = std::min(from.row, to.row);
-        auto beginCol = std::min(static_cast<unsigned int>(from.col), static_cast<unsigned int>(to.col));
+    Game();
 
-        auto endRow = std::max(from.row, to.row);
-        auto endCol = std::max(static_cast<unsigned int>(from.col), static_cast<unsigned int>(to.col));
+    ~Game() = default;
 
-        _begin = Position{ .row = beginRow, .col = static_cast<char>(beginCol) };
-        _end = Position{ .row = endRow, .col = static_cast<char>(endCol) };
+    // replaces the whole position; a malformed FEN leaves the game as it was
+    std::expected<void, FenError> parseFEN(std::string_view fenString);
 
-        _current = _begin;
-    }
+    // replaces the whole position, e.g. with one of those `parseFENBatch()` produces; the move history is cleared
+    void loadPosition(const PackedPosition& position);
 
-    Position operator*() const {
-        return _current;
-    }
+    std::string serializeAsFEN() const;
 
-    bool operator==(const PositionIterator& it) const {
-        return _current == it._current;
-    }
+    // writes the FEN into the buffer without allocating; see `serializeFENPosition()`
+    std::size_t serializeAsFEN(std::span<char> buffer) const;
 
-    // prefix
-    PositionIterator& operator++() {
-        _current.row += dRow;
-        _current.col = static_cast<char>(_current.col + dCol);
-        return *this;
-    }
+    // the position without any of the derived state, e.g. for `serializeFENBatch()`
+    PackedPosition packPosition() const;
 
-    // postfix
-    PositionIterator operator++(int x) {
-        PositionIterator tmp = *this;
-        ++(*this);
-        return tmp;
-    }
+    // a move in SAN (`e4`, `Nbd7`, `exd8=Q+`, `O-O-O` and the like) matched against the legal moves in one pass;
+    // no match or more than one gives nothing
+    std::optional<Move> parseMove(std::string_view moveString) const;
+    std::optional<PackedMove> parsePackedMove(std::string_view moveString) const;
 
-    bool hasNext() const {
-        return _current.row != _end.row &&
-            _current.col != _end.col &&
-            _current.row >= 1 &&
-            _current.row <= 8 &&
-            _current.col >= 'a' &&
-            _current.col <= 'h';
-    }
+    // SAN of a legal move in the current position; an empty string for any other move
+    std::string serializeMove(const Move move) const;
 
-protected:
-    Position _begin;
-    Position _end;
-    Position _current;
+    // writes a legal move in the given notation into the buffer, without a terminating zero; returns the number of
+    // characters written, or 0 (leaving the buffer alone) for a move which is not legal or does not fit
+    std::size_t serializeMove(const PackedMove move, std::span<char> buffer, MoveNotation notation = SAN_NOTATION) const;
 
-    int dRow;
-    int dCol;
-};
+    // writes the moves of a game played from the current position into the buffer, separated by spaces; the game is
+    // replayed once on a copy, so each position is generated only once for both the disambiguation of the move
+    // and the check or mate mark of the previous one; stops at the first illegal move or when the buffer is full
+    MovesSerializeResult serializeMoves(std::span<const Move> moves, std::span<char> buffer, MoveNotation notation = SAN_NOTATION) const;
 
-class RookMoveIterator : public PositionIterator {
-public:
-    RookMoveIterator(const Position from, const Position to) : PositionIterator(from, to) {
-        if (from.col == to.col) {
-            dRow = (static_cast<int>(to.row) - static_cast<int>(from.row)) / std::abs(static_cast<int>(to.row) - static_cast<int>(from.row));
-        }
-        else if (from.row == to.row) {
-            dCol = (to.col - from.col) / std::abs(to.col - from.col);
-        }
-        else {
-            throw std::format("Can not create vertical iterator from ({0}, {1}) to ({2}, {3}) - both cols and rows differ, must be same on one dimension", from.row, from.col, to.row, to.col);
-        }
-
-        // initialize iterator advanced by one position to prevent unnecessary checks
-        ++(*this);
-    }
-};
+    void applyMove(const Move move);
 
-class BishopMoveIterator : public PositionIterator {
-public:
-    BishopMoveIterator(const Position from, const Position to) : PositionIterator(from, to) {
-        if (from.col == to.col || from.row == to.row) {
-            throw std::format("Can not create diagonal iterator from ({0}, {1}) to ({2}, {3}) - either cols or rows are same, must be different on both dimensions", from.row, from.col, to.row, to.col);
-        }
+    // applies a move known to be legal (e.g. one from `generateLegalMoves()`) without validating it
+    void makeMove(const Move move);
+    void makeMove(const PackedMove move);
 
-        dCol = (to.col - from.col) / std::abs(to.col - from.col);
-        dRow = (static_cast<int>(to.row) - static_cast<int>(from.row)) / std::abs(static_cast<int>(to.row) - static_cast<int>(from.row));
+    // takes back the last move made; there has to be one
+    void undoMove();
 
-        // initialize iterator advanced by one position to prevent unnecessary checks
-        ++(*this);
-    }
-};
+    // conversions between the full and the packed move, both in the context of the current position (before the move is made)
+    PackedMove packMove(const Move move) const;
+    Move unpackMove(const PackedMove move) const;
 
-class QueenMoveIterator : public PositionIterator {
-public:
-    QueenMoveIterator(const Position from, const Position to) : PositionIterator(from, to) {
-        if (from.row == to.row) {
-            dRow = (static_cast<int>(to.row) - static_cast<int>(from.row)) / std::abs(static_cast<int>(to.row) - static_cast<int>(from.row));
-        }
-        else if (from.col == to.col) {
-            dCol = (to.col - from.col) / std::abs(to.col - from.col);
-        }
-        else {
-            dRow = (static_cast<int>(to.row) - static_cast<int>(from.row)) / std::abs(static_cast<int>(to.row) - static_cast<int>(from.row));
-            dCol = (to.col - from.col) / std::abs(to.col - from.col);
-        }
-
-        // initialize iterator advanced by one position to prevent unnecessary checks
-        ++(*this);
-    }
-};
+    bool isValidMove(const Move move) const;
 
-class Game {
-public:
-    Game();
+    // all the legal moves for the current player
+    void generateLegalMoves(MoveList& moves) const;
 
-    ~Game() = default;
+    // legal moves capturing a piece, including en passant and capturing promotions
+    void generateCaptures(MoveList& moves) const;
 
-    void parseFEN(const std::string& FENstring);
+    // legal moves not capturing anything, including castling and non-capturing promotions
+    void generateQuiets(MoveList& moves) const;
 
-    std::string serializeAsFEN() const;
+    // legal moves getting the king out of check; generates nothing when the king is not in check
+    void generateEvasions(MoveList& moves) const;
 
-    std::optional<Move> parseMove(const std::string& moveString) const;
+    bool isInCheck() const;
 
-    std::string serializeMove(const Move move) const;
+    // pieces of the opponent giving check to the king of the side to move
+    Bitboard checkers() const;
 
-    void applyMove(const Move move);
+    // pieces of the side to move which can not leave the line between their king and an opponent slider
+    Bitboard pinned() const;
 
-    bool isValidMove(const Move move) const;
+    // squares the piece on the given square may move to as far as pins are concerned: the line through the king
+    // for a pinned piece, the whole board otherwise
+    Bitboard pinRay(Square square) const;
+
+    // whether a legal move puts the opponent king in check; tested on the bitboards the move would leave, without making it
+    bool givesCheck(const PackedMove move) const;
+
+    // whether a pseudo-legal move (one the piece can make, ignoring the safety of its own king) is legal;
+    // a few mask tests against `checkers()`, `pinned()` and the attack maps
+    bool isLegal(const PackedMove move) const;
+
+    // 64-bit Zobrist key of the position: pieces, side to move, castling rights and en passant square;
+    // kept up to date by every change to the board, so this is a plain read
+    std::uint64_t hash() const;
+
+    // Zobrist key of the pawns of both colors only
+    std::uint64_t pawnHash() const;
+
+    // same as `hash()`, but computed from scratch
+    std::uint64_t computeHash() const;
+
+    std::uint64_t computePawnHash() const;
+
+    // tapered piece-square evaluation from the point of view of the side to move; kept up to date by every change
+    // to the board like `hash()`, so this is an interpolation of two running sums
+    int evaluate() const;
+
+    // same as `evaluate()`, but computed from scratch
+    int computeEvaluation() const;
+
+    // the network is not owned and has to outlive the game and its copies; nullptr (the default) turns it off
+    void setNetwork(const Network* newNetwork);
+
+    // evaluation of the network set with `setNetwork()`, from the point of view of the side to move; the accumulator
+    // follows every change to the board, except for a moved king, whose side is refreshed here when next read;
+    // without a network this is `evaluate()`
+    int evaluateNetwork() const;
 
 public:
     Piece parsePiece(char pieceSymbol) const;
 
     Piece pieceAt(int row, char col) const;
     Piece pieceAt(const Position pos) const;
+    Piece pieceAt(Square square) const;
 
     void setPieceAt(int row, char col, const Piece piece);
     void setPieceAt(const Position pos, const Piece piece);
+    void setPieceAt(Square square, const Piece piece);
 
     void movePiece(Position from, Position to);
+    void movePiece(Square from, Square to);
+
+    void clearBoard();
+
+    Bitboard piecesOf(const PieceColor color) const;
+    Bitboard piecesOf(const PieceColor color, const PieceType type) const;
+    Bitboard occupancy() const;
 
     bool opponentPieceAt(const Position pos) const;
     bool opponentPieceAt(const Position pos, const PieceColor currentPlayerColor) const;
@@ -250,13 +215,112 @@ public:
 
     bool canOpponentMoveTo(const Position pos) const;
 
-    bool isValidMove(const Move move, std::map<Move, bool, MoveComparator>& cache, const PieceColor currentPlayerColor) const;
+    bool isValidMove(const Move move, const PieceColor currentPlayerColor) const;
+
+    bool canOpponentMoveTo(const Position pos, const PieceColor currentPlayerColor) const;
+
+    // squares attacked by the pieces of the given color, computed once per position; the king of the other side
+    // does not block the sliders, so these are exactly the squares that king can not move to
+    Bitboard attackedSquares(const PieceColor byColor) const;
+
+    // square a pawn has just skipped with a two-rank advancement, if the last move was one
+    std::optional<Square> enPassantSquare() const;
+
+    CastlingAvailability castlingAvailability() const;
+
+    // pieces of both colors attacking the square, given the occupancy
+    Bitboard attackersTo(Square square, Bitboard occupiedSquares) const;
 
-    bool canOpponentMoveTo(const Position pos, std::map<Move, bool, MoveComparator>& cache, const PieceColor currentPlayerColor) const;
+    bool isSquareAttacked(Square square, const PieceColor byColor, Bitboard occupiedSquares) const;
+
+    template<MoveGenerationType Type>
+    void generateMoves(MoveList& moves) const;
 
 public:
-    std::array<std::array<Piece, 8>, 8> pieces;
+    // mailbox for `pieceAt()` lookups, kept in sync with the bitboards below by `setPieceAt()`
+    std::array<Piece, 64> board;
+
+    std::array<Bitboard, 12> pieceBitboards;
+    std::array<Bitboard, 2> colorBitboards;
+    Bitboard occupied;
+
     PieceColor currentPlayer;
-    CastlingAvailability castlingAvailability;
-    std::deque<Move> moveHistory;
+
+    // `CastlingRights` mask
+    std::uint8_t castlingRights;
+
+    // set after every two-rank pawn advancement (and by the FEN), whether or not a pawn can capture there
+    std::optional<Square> enPassantTarget;
+
+    // plies since the last capture or pawn move
+    unsigned int halfmoveClock;
+
+    // starts at 1 and goes up after every move of black
+    unsigned int fullmoveNumber;
+
+    // record of the moves made; neither validation nor `undoMove()` read it, so it may be trimmed or cleared at will
+    std::vector<PackedMove> moveHistory;
+    std::vector<UndoState> undoStack;
+
+    std::uint64_t positionKey;
+    std::uint64_t pawnKey;
+
+    Evaluator evaluator;
+
+    const Network* network = nullptr;
+    mutable Accumulator accumulator;
+
+private:
+    // the inputs of the network for a change of the piece on a square, for the sides whose accumulator is computed
+    void updateAccumulator(Piece previous, Piece piece, Square square);
+
+    // the validation of a move by a piece of the given color and type, without the memoization; picked by `isValidMove()`
+    template<PieceColor Color, PieceType Type>
+    bool isValidPieceMove(const Move move) const;
+
+    using PieceMoveValidator = bool (Game::*)(const Move move) const;
+
+    // `generateMoves()` for the given side to move
+    template<PieceColor Us, MoveGenerationType Type>
+    void generateMovesFor(MoveList& moves) const;
+
+    // SAN of a legal move without the check or mate mark, the legal moves of the position are used for the disambiguation
+    std::size_t writeSAN(const PackedMove move, const MoveList& legalMoves, char* out) const;
+
+    void computeAttackMaps() const;
+
+    // filled on the first `attackedSquares()` query after the board changes
+    mutable std::array<Bitboard, 2> attackMaps;
+    mutable bool attackMapsValid = false;
+
+    // `isValidMove()` results for the current position, validated for the given color
+    MoveValidityTable& validityTableFor(const PieceColor color) const;
+
+    mutable MoveValidityTable validityTable;
+    mutable PieceColor validityTableColor = WHITE;
+    mutable bool validityTableValid = false;
+
+    void computeCheckInfo() const;
+
+    // `checkers()` and `pinned()`, computed once per position for the side to move
+    mutable Bitboard checkersCache;
+    mutable Bitboard pinnedCache;
+    mutable PieceColor checkInfoColor = WHITE;
+    mutable bool checkInfoValid = false;
+};
+
+// `std::format("{}", game)` and `std::format_to()` write the FEN of the position, through a buffer on the stack
+template<>
+struct std::formatter<Game, char> {
+    constexpr auto parse(std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(const Game& game, FormatContext& ctx) const {
+        char buffer[MAX_FEN_LENGTH];
+        auto length = game.serializeAsFEN(buffer);
+
+        return std::copy_n(buffer, length, ctx.out());
+    }
 };
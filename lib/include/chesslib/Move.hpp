@@ -0,0 +1,75 @@
+#pragma once
+
+#include <format>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#include "chesslib/Piece.hpp"
+#include "chesslib/Square.hpp"
+
+// row (1 to 8) and column ('a' to 'h') notation of the public move API; everything inside `Game` works on `Square`
+struct Position {
+    unsigned int row;
+    char col;
+
+    void parse(const std::string& positionString) {
+        col = positionString.at(0);
+        row = static_cast<int>(positionString.at(1)) - static_cast<int>('1') + 1;
+    }
+
+    constexpr Square square() const {
+        return makeSquare(row, col);
+    }
+
+    static constexpr Position fromSquare(Square square) {
+        return Position{ .row = static_cast<unsigned int>(square.rank()) + 1, .col = square.fileSymbol() };
+    }
+
+    bool operator==(const Position& other) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, const Position& pos) {
+        return os << std::format("<{1}, {0}>", static_cast<char>(pos.col), pos.row);
+    }
+};
+
+struct Move {
+    Piece piece;
+
+    Position from;
+    Position to;
+
+    std::optional<Piece> promotion;
+
+    bool isCapture;
+    bool isCastling;
+
+    bool operator==(const Move& other) const = default;
+};
+
+template<>
+struct std::hash<Piece> {
+    std::size_t operator()(Piece const& p) const noexcept {
+        return std::hash<char>{}(p);
+    }
+};
+
+template<>
+struct std::hash<Position> {
+    std::size_t operator()(Position const& pos) const noexcept {
+        return std::hash<Square>{}(pos.square());
+    }
+};
+
+template<>
+struct std::hash<Move> {
+    std::size_t operator()(Move const& move) const noexcept {
+        std::size_t h1 = std::hash<Position>{}(move.from);
+        std::size_t h2 = std::hash<Position>{}(move.to);
+        std::size_t h3 = std::hash<Piece>{}(move.piece);
+        std::size_t h4 = std::hash<std::optional<Piece>>{}(move.promotion);
+        std::size_t h5 = std::hash<bool>{}(move.isCapture);
+        std::size_t h6 = std::hash<bool>{}(move.isCastling);
+        return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4) ^ (h6 << 5); // or use boost::hash_combine
+    }
+};
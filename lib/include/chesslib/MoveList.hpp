@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "chesslib/PackedMove.hpp"
+
+// fixed-capacity buffer of packed moves meant to live on the stack, so move generation never touches the heap;
+// no legal chess position has more than 218 moves
+class MoveList {
+public:
+    static constexpr std::size_t CAPACITY = 256;
+
+    void push(PackedMove move) {
+        moves[count++] = move;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    bool contains(PackedMove move) const {
+        return std::find(begin(), end(), move) != end();
+    }
+
+    PackedMove operator[](std::size_t index) const {
+        return moves[index];
+    }
+
+    PackedMove* begin() {
+        return moves.data();
+    }
+
+    PackedMove* end() {
+        return moves.data() + count;
+    }
+
+    const PackedMove* begin() const {
+        return moves.data();
+    }
+
+    const PackedMove* end() const {
+        return moves.data() + count;
+    }
+
+private:
+    std::array<PackedMove, CAPACITY> moves;
+    std::size_t count = 0;
+};
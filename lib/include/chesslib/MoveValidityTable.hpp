@@ -0,0 +1,79 @@
+#pragma once
+
+#include <bitset>
+#include <optional>
+
+#include "chesslib/PackedMove.hpp"
+
+// memo of `Game::isValidMove()` results for a single position: a known/valid pair of 64x64 from/to bitsets for each
+// kind of move and a small side table for promotions, which only go from the 7th rank to the 8th (2nd to 1st for black);
+// flat and allocation-free, so a lookup is a couple of bit tests and a reset is a memset
+class MoveValidityTable {
+public:
+    std::optional<bool> find(PackedMove move) const {
+        auto index = indexOf(move);
+
+        if (index < 0 || !known[index]) {
+            return std::nullopt;
+        }
+
+        return valid[index];
+    }
+
+    void store(PackedMove move, bool isValid) {
+        auto index = indexOf(move);
+
+        if (index < 0) {
+            return;
+        }
+
+        known[index] = true;
+        valid[index] = isValid;
+    }
+
+    void clear() {
+        known.reset();
+    }
+
+private:
+    enum MoveKind {
+        QUIET_KIND = 0,
+        CAPTURE_KIND,
+        CASTLING_KIND,
+        MOVE_KINDS
+    };
+
+    static constexpr int SQUARE_PAIRS = 64 * 64;
+
+    // promoting pawn file (8) x direction (2) x file step of -1, 0 or 1 (3) x promoted piece and capture (8)
+    static constexpr int PROMOTIONS = 8 * 2 * 3 * 8;
+
+    static constexpr int SIZE = SQUARE_PAIRS * MOVE_KINDS + PROMOTIONS;
+
+    // -1 for promotions which can not happen on a board, those are not memoized
+    static constexpr int indexOf(PackedMove move) {
+        auto from = move.from();
+        auto to = move.to();
+
+        if (!move.isPromotion()) {
+            auto kind = move.isCastling() ? CASTLING_KIND : (move.isCapture() ? CAPTURE_KIND : QUIET_KIND);
+
+            return kind * SQUARE_PAIRS + from.index() * 64 + to.index();
+        }
+
+        auto fileStep = to.file() - from.file();
+        auto isWhite = from.rank() == 6 && to.rank() == 7;
+        auto isBlack = from.rank() == 1 && to.rank() == 0;
+
+        if ((!isWhite && !isBlack) || fileStep < -1 || fileStep > 1) {
+            return -1;
+        }
+
+        auto promotion = ((isWhite ? 0 : 1) * 8 + from.file()) * 3 + (fileStep + 1);
+
+        return MOVE_KINDS * SQUARE_PAIRS + promotion * 8 + (move.flags() & 7);
+    }
+
+    std::bitset<SIZE> known;
+    std::bitset<SIZE> valid;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesslib/Bitboard.hpp"
+#include "chesslib/Piece.hpp"
+#include "chesslib/Square.hpp"
+
+// HalfKP: one input for every placement of a piece other than a king (10 kinds on 64 squares), repeated for every
+// square of the king of the side the board is seen from
+inline constexpr std::size_t HALFKP_FEATURES = 64 * 10 * 64;
+
+// 2 x 256 accumulated inputs (the side to move first), then two hidden layers of 32 and one output
+inline constexpr std::size_t ACCUMULATOR_SIZE = 256;
+inline constexpr std::size_t HIDDEN_LAYER1_SIZE = 32;
+inline constexpr std::size_t HIDDEN_LAYER2_SIZE = 32;
+
+// hidden layer sums are shifted right by this before clipping to 0..127; the output is divided by the scale
+inline constexpr int WEIGHT_SHIFT = 6;
+inline constexpr int OUTPUT_SCALE = 16;
+
+enum NetworkError {
+    NETWORK_FILE_UNREADABLE,
+    INVALID_NETWORK_HEADER,
+    TRUNCATED_NETWORK,
+    TRAILING_NETWORK_DATA
+};
+
+std::string_view networkErrorMessage(NetworkError error);
+
+// instruction sets the network can run on, from the slowest; picked once when the network is created
+enum SimdLevel {
+    NO_SIMD,
+    SSE41_SIMD,
+    AVX2_SIMD
+};
+
+// the best level the CPU we are running on supports
+SimdLevel detectSimdLevel();
+
+// the first layer of the network summed over the active features, once from the point of view of each side
+// (indexed by `colorIndex()`); a side which is not `computed` has to be refreshed before it is read
+struct alignas(64) Accumulator {
+    std::array<std::array<std::int16_t, ACCUMULATOR_SIZE>, 2> values;
+    std::array<bool, 2> computed{ false, false };
+};
+
+// quantized HalfKP network: 16-bit feature weights accumulated with wrapping adds, 8-bit weights in the hidden layers
+// over inputs clipped to 0..127, so that the SSE4.1 and AVX2 paths give the very same results as the scalar one
+class Network {
+public:
+    // the network file: the header (magic, version, then the four layer sizes as 32-bit words), followed by the
+    // biases and weights of every layer in order, all little-endian; see `serialize()`
+    static std::expected<std::unique_ptr<Network>, NetworkError> load(const std::string& path);
+    static std::expected<std::unique_ptr<Network>, NetworkError> parse(std::span<const char> data);
+
+    // a network with random weights, the same for the same seed; it plays no chess, but it costs the same to run,
+    // which is all tests and benchmarks need
+    static std::unique_ptr<Network> random(std::uint64_t seed);
+
+    std::vector<char> serialize() const;
+    bool save(const std::string& path) const;
+
+    // index of the input for a piece on a square, seen from the given side with its king on the given square;
+    // black sees the board flipped vertically, and pieces are told apart as its own and the opponent's
+    static std::size_t featureIndex(PieceColor perspective, Square kingSquare, Piece piece, Square square) {
+        auto flip = perspective == WHITE ? 0 : 56;
+        auto kind = pieceType(piece) * 2 + (pieceColor(piece) == perspective ? 0 : 1);
+
+        return static_cast<std::size_t>((kingSquare.index() ^ flip) * 640 + kind * 64 + (square.index() ^ flip));
+    }
+
+    void addFeature(Accumulator& accumulator, PieceColor perspective, std::size_t feature) const;
+    void removeFeature(Accumulator& accumulator, PieceColor perspective, std::size_t feature) const;
+
+    // the accumulator of one side recomputed from all the pieces on the board (indexed like `Game::pieceBitboards`)
+    void refreshAccumulator(Accumulator& accumulator, PieceColor perspective, const std::array<Bitboard, 12>& pieceBitboards) const;
+
+    // the hidden layers and the output over a computed accumulator, in centipawns for the side to move
+    int evaluate(const Accumulator& accumulator, PieceColor sideToMove) const;
+
+    SimdLevel simdLevel() const;
+
+    // e.g. to compare the paths; a level the CPU does not support is refused
+    bool setSimdLevel(SimdLevel newLevel);
+
+private:
+    Network();
+
+    std::vector<std::int16_t> transformerBiases;
+    std::vector<std::int16_t> transformerWeights;
+
+    std::vector<std::int32_t> hidden1Biases;
+    std::vector<std::int8_t> hidden1Weights;
+
+    std::vector<std::int32_t> hidden2Biases;
+    std::vector<std::int8_t> hidden2Weights;
+
+    std::int32_t outputBias;
+    std::vector<std::int8_t> outputWeights;
+
+    SimdLevel level;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "chesslib/Bitboard.hpp"
+#include "chesslib/Piece.hpp"
+#include "chesslib/Move.hpp"
+
+// the 4 flag bits of a packed move; bit 2 marks captures and bit 3 marks promotions, the lowest two bits of a
+// promotion are the promoted piece (knight, bishop, rook, queen)
+enum MoveFlag : std::uint8_t {
+    QUIET_MOVE = 0,
+    DOUBLE_PAWN_PUSH = 1,
+    KING_SIDE_CASTLING = 2,
+    QUEEN_SIDE_CASTLING = 3,
+    CAPTURE = 4,
+    EN_PASSANT_CAPTURE = 5,
+
+    KNIGHT_PROMOTION = 8,
+    BISHOP_PROMOTION = 9,
+    ROOK_PROMOTION = 10,
+    QUEEN_PROMOTION = 11,
+
+    KNIGHT_PROMOTION_CAPTURE = 12,
+    BISHOP_PROMOTION_CAPTURE = 13,
+    ROOK_PROMOTION_CAPTURE = 14,
+    QUEEN_PROMOTION_CAPTURE = 15
+};
+
+// a move squeezed into 16 bits: from square (6 bits) | to square (6 bits) | flags (4 bits);
+// the moving piece is not stored, it is the one standing on the from square before the move is made
+class PackedMove {
+public:
+    constexpr PackedMove() : data(0) {}
+
+    constexpr PackedMove(Square from, Square to, MoveFlag flags) :
+        data(static_cast<std::uint16_t>(from.index() | (to.index() << 6) | (flags << 12)))
+    {}
+
+    // `isEnPassant` can not be told from the move alone, it depends on the square captured on being empty;
+    // only a king going two files from its home square is packed as castling, whatever `isCastling` says
+    static constexpr PackedMove fromMove(const Move& move, bool isEnPassant = false) {
+        auto from = move.from.square();
+        auto to = move.to.square();
+
+        if (move.isCastling && pieceType(move.piece) == KING && from.file() == 4 && (from.rank() == 0 || from.rank() == 7) &&
+            to.rank() == from.rank() && (to.file() == 6 || to.file() == 2)) {
+            return PackedMove(from, to, (to.file() > from.file()) ? KING_SIDE_CASTLING : QUEEN_SIDE_CASTLING);
+        }
+
+        if (move.promotion.has_value()) {
+            auto flags = static_cast<int>(KNIGHT_PROMOTION) + (pieceType(*move.promotion) - KNIGHT) + (move.isCapture ? CAPTURE : 0);
+
+            return PackedMove(from, to, static_cast<MoveFlag>(flags));
+        }
+
+        if (move.isCapture) {
+            return PackedMove(from, to, isEnPassant ? EN_PASSANT_CAPTURE : CAPTURE);
+        }
+
+        if (pieceType(move.piece) == PAWN && (to.rank() - from.rank() == 2 || from.rank() - to.rank() == 2)) {
+            return PackedMove(from, to, DOUBLE_PAWN_PUSH);
+        }
+
+        return PackedMove(from, to, QUIET_MOVE);
+    }
+
+    constexpr Square from() const {
+        return Square(data & 0x3F);
+    }
+
+    constexpr Square to() const {
+        return Square((data >> 6) & 0x3F);
+    }
+
+    constexpr MoveFlag flags() const {
+        return static_cast<MoveFlag>(data >> 12);
+    }
+
+    constexpr bool isCapture() const {
+        return (flags() & CAPTURE) != 0;
+    }
+
+    constexpr bool isPromotion() const {
+        return (flags() & KNIGHT_PROMOTION) != 0;
+    }
+
+    constexpr bool isCastling() const {
+        return flags() == KING_SIDE_CASTLING || flags() == QUEEN_SIDE_CASTLING;
+    }
+
+    constexpr bool isEnPassant() const {
+        return flags() == EN_PASSANT_CAPTURE;
+    }
+
+    constexpr bool isDoublePawnPush() const {
+        return flags() == DOUBLE_PAWN_PUSH;
+    }
+
+    // only meaningful for promotions
+    constexpr PieceType promotionType() const {
+        return static_cast<PieceType>(KNIGHT + (flags() & 3));
+    }
+
+    // the full move, given the piece which makes it; the promoted piece takes the color of that piece
+    constexpr Move toMove(Piece piece) const {
+        return Move{
+            .piece = piece,
+            .from = Position::fromSquare(from()),
+            .to = Position::fromSquare(to()),
+            .promotion = isPromotion() ? std::optional<Piece>(makePiece(pieceColor(piece), promotionType())) : std::nullopt,
+            .isCapture = isCapture(),
+            .isCastling = isCastling()
+        };
+    }
+
+    constexpr std::uint16_t raw() const {
+        return data;
+    }
+
+    constexpr bool operator==(const PackedMove& other) const = default;
+    constexpr auto operator<=>(const PackedMove& other) const = default;
+
+private:
+    std::uint16_t data;
+};
+
+template<>
+struct std::hash<PackedMove> {
+    std::size_t operator()(PackedMove const& move) const noexcept {
+        return std::hash<std::uint16_t>{}(move.raw());
+    }
+};
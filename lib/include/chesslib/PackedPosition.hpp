@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "chesslib/Piece.hpp"
+#include "chesslib/Square.hpp"
+
+// castling rights as a 4-bit mask, which is also the index into `ZobristKeys::castling`
+enum CastlingRights : std::uint8_t {
+    NO_CASTLING = 0,
+
+    WHITE_KING_SIDE_CASTLING = 1,
+    WHITE_QUEEN_SIDE_CASTLING = 2,
+    BLACK_KING_SIDE_CASTLING = 4,
+    BLACK_QUEEN_SIDE_CASTLING = 8,
+
+    ALL_CASTLING = 15
+};
+
+// a position the way a FEN string describes it, in 38 bytes: the board as 4-bit piece codes (two squares per byte,
+// 0 for an empty square, `pieceIndex() + 1` for a piece) and the state fields; none of the data `Game` derives from
+// it (bitboards, hash keys), `Game::loadPosition()` rebuilds that
+struct PackedPosition {
+    static constexpr std::uint8_t NO_EN_PASSANT = 64;
+
+    std::array<std::uint8_t, 32> pieces{};
+
+    PieceColor currentPlayer = WHITE;
+
+    // `CastlingRights` mask
+    std::uint8_t castlingRights = NO_CASTLING;
+
+    // square index, `NO_EN_PASSANT` when there is none
+    std::uint8_t enPassantTarget = NO_EN_PASSANT;
+
+    std::uint16_t halfmoveClock = 0;
+    std::uint16_t fullmoveNumber = 1;
+
+    constexpr Piece pieceAt(Square square) const {
+        constexpr Piece codePieces[] = {
+            NONE,
+            WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING,
+            BLACK_PAWN, BLACK_KNIGHT, BLACK_BISHOP, BLACK_ROOK, BLACK_QUEEN, BLACK_KING,
+            NONE, NONE, NONE
+        };
+
+        return codePieces[(pieces[square.index() >> 1] >> ((square.index() & 1) * 4)) & 0xF];
+    }
+
+    constexpr void setPieceAt(Square square, Piece piece) {
+        auto code = static_cast<std::uint8_t>(piece == NONE ? 0 : pieceIndex(piece) + 1);
+        auto shift = (square.index() & 1) * 4;
+        auto& byte = pieces[square.index() >> 1];
+
+        byte = static_cast<std::uint8_t>((byte & ~(0xF << shift)) | (code << shift));
+    }
+
+    constexpr std::optional<Square> enPassantSquare() const {
+        return enPassantTarget == NO_EN_PASSANT ? std::nullopt : std::optional<Square>(Square(enPassantTarget));
+    }
+
+    constexpr bool operator==(const PackedPosition& other) const = default;
+};
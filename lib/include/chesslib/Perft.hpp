@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chesslib/Game.hpp"
+#include "chesslib/ThreadPool.hpp"
+
+struct PerftPosition {
+    const char* name;
+    const char* fen;
+
+    // expected leaf node counts for depths 1..6, zero where the count is too expensive to be worth checking
+    std::array<std::uint64_t, 6> nodes;
+};
+
+// the standard reference positions, see https://www.chessprogramming.org/Perft_Results
+inline constexpr std::array<PerftPosition, 6> PERFT_POSITIONS{
+    {
+        { "start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", { 20, 400, 8902, 197281, 4865609, 119060324 } },
+        { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", { 48, 2039, 97862, 4085603, 193690690, 8031647685 } },
+        { "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", { 14, 191, 2812, 43238, 674624, 11030083 } },
+        { "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", { 6, 264, 9467, 422333, 15833292, 706045033 } },
+        { "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", { 44, 1486, 62379, 2103487, 89941194, 0 } },
+        { "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", { 46, 2079, 89890, 3894594, 164075551, 6923051137 } }
+    }
+};
+
+// cache of subtree counts keyed on the position hash and the remaining depth; a fixed, power-of-two number of entries
+// shared by all the threads without locks: each entry keeps its data together with `key ^ data`, so an entry torn by
+// concurrent writes fails the key check and reads as a miss instead of a wrong count
+class PerftTable {
+public:
+    explicit PerftTable(std::size_t megabytes);
+
+    bool probe(std::uint64_t key, int depth, std::uint64_t& nodes) const;
+    void store(std::uint64_t key, int depth, std::uint64_t nodes);
+
+    void clear();
+
+    std::size_t size() const;
+
+    // lookups are counted by the callers and added here in bulk, to keep threads off a shared counter
+    void addStatistics(std::uint64_t probes, std::uint64_t hits);
+
+    std::uint64_t probes() const;
+    std::uint64_t hits() const;
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask;
+
+    std::atomic<std::uint64_t> probeCount;
+    std::atomic<std::uint64_t> hitCount;
+};
+
+struct PerftDivide {
+    PackedMove move;
+    std::uint64_t nodes;
+};
+
+// number of leaf nodes of the legal move tree of the given depth
+std::uint64_t perft(const Game& game, int depth);
+
+// same as above, reusing the counts of subtrees already stored in the table
+std::uint64_t perft(const Game& game, int depth, PerftTable& table);
+
+// leaf node counts under every root move, in the order the moves are generated; the table is optional
+std::vector<PerftDivide> perftDivide(const Game& game, int depth, PerftTable* table = nullptr);
+
+// same as above, but the tree is split into tasks for the first `splitDepth` plies and counted on the pool;
+// each task owns its copy of the game, and the counts are identical to the single-threaded ones
+std::vector<PerftDivide> perftDivide(const Game& game, int depth, ThreadPool& pool, int splitDepth, PerftTable* table = nullptr);
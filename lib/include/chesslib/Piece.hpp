@@ -0,0 +1,85 @@
+#pragma once
+
+enum PieceColor : char {
+    BLACK = 'b',
+    WHITE = 'w'
+};
+
+enum Piece : char {
+    NONE = 0,
+
+    WHITE_PAWN = 'P',
+    WHITE_ROOK = 'R',
+    WHITE_KNIGHT = 'N',
+    WHITE_BISHOP = 'B',
+    WHITE_QUEEN = 'Q',
+    WHITE_KING = 'K',
+
+    BLACK_PAWN = 'p',
+    BLACK_ROOK = 'r',
+    BLACK_KNIGHT = 'n',
+    BLACK_BISHOP = 'b',
+    BLACK_QUEEN = 'q',
+    BLACK_KING = 'k'
+};
+
+enum PieceType {
+    PAWN = 0,
+    KNIGHT,
+    BISHOP,
+    ROOK,
+    QUEEN,
+    KING
+};
+
+constexpr int colorIndex(PieceColor color) {
+    return color == WHITE ? 0 : 1;
+}
+
+constexpr PieceColor opponentColor(PieceColor color) {
+    return color == WHITE ? BLACK : WHITE;
+}
+
+// black pieces are noted with lowercase letters, white pieces - with uppercase ones
+constexpr PieceColor pieceColor(Piece piece) {
+    return piece >= 'a' ? BLACK : WHITE;
+}
+
+constexpr PieceType pieceType(Piece piece) {
+    switch (piece) {
+    case WHITE_KNIGHT:
+    case BLACK_KNIGHT:
+        return KNIGHT;
+
+    case WHITE_BISHOP:
+    case BLACK_BISHOP:
+        return BISHOP;
+
+    case WHITE_ROOK:
+    case BLACK_ROOK:
+        return ROOK;
+
+    case WHITE_QUEEN:
+    case BLACK_QUEEN:
+        return QUEEN;
+
+    case WHITE_KING:
+    case BLACK_KING:
+        return KING;
+
+    default:
+        return PAWN;
+    }
+}
+
+constexpr Piece makePiece(PieceColor color, PieceType type) {
+    constexpr Piece whitePieces[] = { WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING };
+    constexpr Piece blackPieces[] = { BLACK_PAWN, BLACK_KNIGHT, BLACK_BISHOP, BLACK_ROOK, BLACK_QUEEN, BLACK_KING };
+
+    return color == WHITE ? whitePieces[type] : blackPieces[type];
+}
+
+// index into Game::pieceBitboards: white pieces first, then black ones, each ordered by PieceType
+constexpr int pieceIndex(Piece piece) {
+    return colorIndex(pieceColor(piece)) * 6 + pieceType(piece);
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "chesslib/Game.hpp"
+#include "chesslib/ThreadPool.hpp"
+#include "chesslib/TranspositionTable.hpp"
+
+// plies a search can go down, quiescence and check extensions included
+inline constexpr int MAX_SEARCH_PLY = 128;
+
+// iterations `Searcher::search()` runs when no depth limit is given
+inline constexpr int MAX_SEARCH_DEPTH = 64;
+
+// centipawn scores are well within these; being mated in N plies scores `-MATE_SCORE + N`, mating scores `MATE_SCORE - N`
+inline constexpr int MATE_SCORE = 32000;
+inline constexpr int INFINITE_SCORE = 32001;
+
+// any score beyond this is a mate found by the search
+inline constexpr int MATE_BOUND = MATE_SCORE - MAX_SEARCH_PLY;
+
+// size of the table a `Searcher` creates for itself when it is not given one
+inline constexpr std::size_t DEFAULT_TABLE_MEGABYTES = 16;
+
+// the search stops at whichever limit is reached first; zero means no limit on nodes or time
+struct SearchLimits {
+    int depth = MAX_SEARCH_DEPTH;
+    std::uint64_t nodes = 0;
+    std::chrono::milliseconds time = std::chrono::milliseconds::zero();
+};
+
+// the outcome of the last completed iteration, plus the work done so far
+struct SearchResult {
+    // a null move (`PackedMove()`) when the side to move has no legal moves
+    PackedMove bestMove;
+
+    // centipawns from the point of view of the side to move, see `MATE_SCORE` for mates
+    int score;
+
+    // depth of the last completed iteration
+    int depth;
+
+    // principal variation, starting with the best move
+    std::vector<PackedMove> pv;
+
+    std::uint64_t nodes;
+    std::chrono::milliseconds elapsed;
+    std::uint64_t nodesPerSecond;
+};
+
+// iterative deepening negamax with alpha-beta pruning and principal variation search over a copy of the game;
+// all the per-ply state lives in fixed arrays of the searcher and moves are made and taken back in place,
+// so the tree is searched without touching the heap
+class Searcher {
+public:
+    using IterationCallback = std::function<void(const SearchResult& result)>;
+
+    // with a table of its own, `DEFAULT_TABLE_MEGABYTES` large
+    Searcher();
+
+    // with a table which may be shared with other searchers; it has to outlive this one
+    explicit Searcher(TranspositionTable& table);
+
+    SearchResult search(const Game& game, const SearchLimits& limits);
+
+    // asks a running search to return as soon as possible, with the result of the last completed iteration;
+    // safe to call from any thread
+    void stop();
+
+    // called after every completed iteration, e.g. to print the `info` lines of a UCI engine
+    void setIterationCallback(IterationCallback callback);
+
+    // the search also stops once the flag is set; unlike `stop()` the flag is not reset by `search()`,
+    // so one flag set before a search starts still stops it
+    void setStopFlag(const std::atomic<bool>* flag);
+
+    // a nonzero index makes this a helper of a parallel search: it skips some of the iterations, depending on the index,
+    // to stay ahead of the other threads, orders quiet moves a little differently and leaves the table's age alone
+    void setHelperIndex(unsigned int index);
+
+private:
+    int negamax(int alpha, int beta, int depth, int ply);
+    int quiescence(int alpha, int beta, int ply);
+
+    int evaluate() const;
+
+    // fifty-move rule and repetitions since the last irreversible move
+    bool isDraw() const;
+
+    // orders the moves, best first, by the given scores as they are picked; the move from the table goes first
+    void scoreMoves(const MoveList& moves, std::array<int, MoveList::CAPACITY>& scores, int ply, PackedMove tableMove) const;
+
+    // counts the node and checks the limits; true once the search has to stop
+    bool countNode();
+
+    void updatePV(int ply, PackedMove move);
+
+    std::unique_ptr<TranspositionTable> ownTable;
+    TranspositionTable* table;
+
+    // counted here and added to the table's statistics when the search ends
+    std::uint64_t tableProbes;
+    std::uint64_t tableHits;
+
+    Game game;
+
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::uint64_t nodes;
+    bool stopped;
+    std::atomic<bool> stopRequested;
+    const std::atomic<bool>* stopFlag;
+
+    unsigned int helperIndex;
+
+    IterationCallback iterationCallback;
+
+    // triangular table of principal variations: the line found below each ply
+    std::array<std::array<PackedMove, MAX_SEARCH_PLY>, MAX_SEARCH_PLY> pvTable;
+    std::array<int, MAX_SEARCH_PLY> pvLength;
+
+    // the line of the previous iteration, tried first
+    std::array<PackedMove, MAX_SEARCH_PLY> previousPV;
+    int previousPVLength;
+
+    // two quiet moves per ply which caused a beta cutoff
+    std::array<std::array<PackedMove, 2>, MAX_SEARCH_PLY> killers;
+
+    // how well quiet moves did by side, from and to square
+    std::array<std::array<std::array<int, 64>, 64>, 2> history;
+};
+
+// Lazy SMP: the main searcher runs on the calling thread and owns the limits, while helpers on the other threads search
+// the same root with no limits of their own, sharing the table; the threads only meet through the table, and the helpers
+// are stopped as soon as the main search ends; the pool and the searchers are kept between searches, so even short
+// searches do not pay for starting threads
+class ParallelSearcher {
+public:
+    ParallelSearcher(unsigned int threadCount, TranspositionTable& table);
+
+    ParallelSearcher(const ParallelSearcher&) = delete;
+    ParallelSearcher& operator=(const ParallelSearcher&) = delete;
+
+    // the result of the main searcher, or of a helper which completed a deeper iteration; nodes are counted on all the threads
+    SearchResult search(const Game& game, const SearchLimits& limits);
+
+    // safe to call from any thread; a stop which comes before `search()` is kept and ends that search at once
+    void stop();
+
+    // called after every iteration completed by the main searcher
+    void setIterationCallback(Searcher::IterationCallback callback);
+
+    unsigned int threadCount() const;
+
+private:
+    std::atomic<bool> stopping;
+
+    // the main searcher first
+    std::vector<std::unique_ptr<Searcher>> searchers;
+    std::vector<SearchResult> helperResults;
+
+    // one worker per helper, none for a single thread
+    std::unique_ptr<ThreadPool> pool;
+};
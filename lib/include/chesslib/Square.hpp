@@ -0,0 +1,85 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// a single square of the board, a1 = 0, b1 = 1, ..., h8 = 63; files and ranks are counted from 0
+class Square {
+public:
+    constexpr Square() : value(0) {}
+
+    constexpr explicit Square(int index) : value(static_cast<std::uint8_t>(index)) {}
+
+    static constexpr Square fromFileRank(int file, int rank) {
+        return Square(rank * 8 + file);
+    }
+
+    // "e4" and the like; anything but a file letter followed by a rank digit is rejected
+    static constexpr std::optional<Square> fromAlgebraic(std::string_view notation) {
+        if (notation.size() < 2 || notation[0] < 'a' || notation[0] > 'h' || notation[1] < '1' || notation[1] > '8') {
+            return std::nullopt;
+        }
+
+        return fromFileRank(notation[0] - 'a', notation[1] - '1');
+    }
+
+    constexpr int index() const {
+        return value;
+    }
+
+    constexpr int file() const {
+        return value & 7;
+    }
+
+    constexpr int rank() const {
+        return value >> 3;
+    }
+
+    constexpr char fileSymbol() const {
+        return static_cast<char>('a' + file());
+    }
+
+    constexpr char rankSymbol() const {
+        return static_cast<char>('1' + rank());
+    }
+
+    std::string toAlgebraic() const {
+        return std::string{ fileSymbol(), rankSymbol() };
+    }
+
+    // shifts by whole squares, e.g. `square + 8` is the square right above
+    constexpr Square operator+(int offset) const {
+        return Square(value + offset);
+    }
+
+    constexpr Square operator-(int offset) const {
+        return Square(value - offset);
+    }
+
+    constexpr bool operator==(const Square& other) const = default;
+    constexpr auto operator<=>(const Square& other) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, const Square& square) {
+        return os << square.toAlgebraic();
+    }
+
+private:
+    std::uint8_t value;
+};
+
+// the square in the row/column notation the `Position` and the move parsing use, rows counted from 1
+constexpr Square makeSquare(unsigned int row, char col) {
+    return Square::fromFileRank(col - 'a', static_cast<int>(row) - 1);
+}
+
+template<>
+struct std::hash<Square> {
+    std::size_t operator()(Square const& square) const noexcept {
+        return std::hash<int>{}(square.index());
+    }
+};
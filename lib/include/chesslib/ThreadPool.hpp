@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads, each owning a task queue; a worker takes the newest task from its own queue
+// and, once that is empty, steals the oldest task of another worker, so unbalanced work spreads across all threads
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned int threadCount);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // tasks submitted from a worker thread go to that worker's own queue, others are spread round-robin
+    void submit(Task task);
+
+    // blocks until every submitted task, including the ones submitted by other tasks, has finished
+    void wait();
+
+    unsigned int size() const;
+
+private:
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned int index);
+
+    bool popTask(unsigned int index, Task& task);
+    bool stealTask(unsigned int index, Task& task);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allTasksDone;
+
+    // submitted but not finished yet
+    std::atomic<std::size_t> pendingTasks;
+
+    // sitting in one of the queues
+    std::atomic<std::size_t> queuedTasks;
+
+    std::atomic<unsigned int> nextQueue;
+
+    bool stopping;
+};
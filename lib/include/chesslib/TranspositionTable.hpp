@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "chesslib/PackedMove.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// what a stored score says about the real one
+enum ScoreBound : std::uint8_t {
+    NO_BOUND = 0,
+
+    // the search failed low, the real score is at most this
+    UPPER_BOUND,
+
+    // the search failed high, the real score is at least this
+    LOWER_BOUND,
+
+    EXACT_BOUND
+};
+
+// one position found in the table
+struct TranspositionEntry {
+    PackedMove move;
+    int score;
+    int depth;
+    ScoreBound bound;
+};
+
+// cache of search results keyed on the position hash, shared by any number of threads without locks; like `PerftTable`,
+// each 16-byte entry keeps its data together with `key ^ data`, so an entry torn by concurrent writes reads as a miss;
+// entries come in buckets of one cache line, and the one replaced is the shallowest, counting older searches as shallower
+class TranspositionTable {
+public:
+    static constexpr std::size_t BUCKET_SIZE = 4;
+
+    // the number of entries is rounded down to a power of two; with `hugePages` the memory is aligned to and advised
+    // for transparent huge pages where the system has them, which saves TLB misses on large tables
+    explicit TranspositionTable(std::size_t megabytes, bool hugePages = false);
+
+    // drops all the entries
+    void resize(std::size_t megabytes, bool hugePages = false);
+
+    void clear();
+
+    // starts a new age, so that the entries of the previous searches go first
+    void newSearch();
+
+    bool probe(std::uint64_t key, TranspositionEntry& entry) const;
+    void store(std::uint64_t key, PackedMove move, int score, int depth, ScoreBound bound);
+
+    // starts loading the bucket of the key into the cache, for a probe coming shortly after, e.g. right after a move is made
+    void prefetch(std::uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets[key & mask]);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(reinterpret_cast<const char*>(&buckets[key & mask]), _MM_HINT_T0);
+#endif
+    }
+
+    // number of entries
+    std::size_t size() const;
+
+    // whether the memory has been advised for huge pages
+    bool usesHugePages() const;
+
+    // lookups are counted by the callers and added here in bulk, to keep threads off a shared counter
+    void addStatistics(std::uint64_t probes, std::uint64_t hits);
+
+    std::uint64_t probes() const;
+    std::uint64_t hits() const;
+
+    // entries out of a thousand written by the current search, sampled from the start of the table (the UCI `hashfull`)
+    int fillPermille() const;
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        std::array<Entry, BUCKET_SIZE> entries;
+    };
+
+    struct FreeDeleter {
+        void operator()(Bucket* buckets) const;
+    };
+
+    std::unique_ptr<Bucket[], FreeDeleter> buckets;
+    std::size_t mask;
+    bool hugePages;
+
+    // 6 bits, stored in every entry; atomic since a new search may start while helpers of a parallel one are still storing
+    std::atomic<std::uint8_t> generation;
+
+    std::atomic<std::uint64_t> probeCount;
+    std::atomic<std::uint64_t> hitCount;
+};
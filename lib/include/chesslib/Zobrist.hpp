@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// random keys XOR-ed together to identify a position: one per piece on a square, one per castling rights
+// combination, one per en passant file and one for black to move
+struct ZobristKeys {
+    std::array<std::array<std::uint64_t, 64>, 12> pieces;
+    std::array<std::uint64_t, 16> castling;
+    std::array<std::uint64_t, 8> enPassant;
+    std::uint64_t blackToMove;
+};
+
+constexpr ZobristKeys generateZobristKeys() {
+    // splitmix64 with a fixed seed, so the keys (and hence the hashes) are the same in every build
+    std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    auto next = [&state]() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+
+    ZobristKeys keys{};
+
+    for (auto& squares : keys.pieces) {
+        for (auto& key : squares) {
+            key = next();
+        }
+    }
+
+    // combinations of rights are XORs of the single rights, so that each right can be toggled on its own
+    std::array<std::uint64_t, 4> rights{ next(), next(), next(), next() };
+
+    for (int mask = 0; mask < 16; ++mask) {
+        for (int right = 0; right < 4; ++right) {
+            if (mask & (1 << right)) {
+                keys.castling[mask] ^= rights[right];
+            }
+        }
+    }
+
+    for (auto& key : keys.enPassant) {
+        key = next();
+    }
+
+    keys.blackToMove = next();
+
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = generateZobristKeys();
@@ -0,0 +1,192 @@
+#include "chesslib/Attacks.hpp"
+
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+std::array<SlidingAttacks, 64> ROOK_ATTACKS;
+std::array<SlidingAttacks, 64> BISHOP_ATTACKS;
+
+bool USE_PEXT = false;
+
+namespace {
+    // sum over all squares of 2^(relevant blocker bits)
+    std::array<Bitboard, 0x19000> rookTable;
+    std::array<Bitboard, 0x1480> bishopTable;
+
+    constexpr Bitboard RANK_1 = 0xFFULL;
+    constexpr Bitboard RANK_8 = RANK_1 << 56;
+    constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    constexpr Bitboard FILE_H = FILE_A << 7;
+
+    constexpr int ROOK_DIRECTIONS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    constexpr int BISHOP_DIRECTIONS[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+
+    // walks the rays one square at a time; only used to fill the tables
+    Bitboard slidingAttacks(int square, Bitboard occupied, const int directions[4][2]) {
+        Bitboard attacks = EMPTY_BITBOARD;
+
+        for (int i = 0; i < 4; ++i) {
+            int row = square / 8 + directions[i][0];
+            int col = square % 8 + directions[i][1];
+
+            while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                auto bit = squareBit(Square::fromFileRank(col, row));
+
+                attacks |= bit;
+
+                if (occupied & bit) {
+                    break;
+                }
+
+                row += directions[i][0];
+                col += directions[i][1];
+            }
+        }
+
+        return attacks;
+    }
+
+    // xorshift64* generator; fixed seeds make the magic search deterministic and fast
+    class MagicRandom {
+    public:
+        explicit MagicRandom(std::uint64_t seed) : state(seed) {}
+
+        std::uint64_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        }
+
+        // magics with few bits set are found much faster
+        std::uint64_t sparse() {
+            return next() & next() & next();
+        }
+
+    private:
+        std::uint64_t state;
+    };
+
+    void initSlidingAttacks(std::array<SlidingAttacks, 64>& entries, Bitboard* table, const int directions[4][2]) {
+        constexpr std::uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+        std::array<Bitboard, 4096> occupancies;
+        std::array<Bitboard, 4096> reference;
+        std::array<int, 4096> epoch{};
+
+        int attempt = 0;
+        Bitboard* attacks = table;
+
+        for (int square = 0; square < 64; ++square) {
+            auto& entry = entries[square];
+
+            Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * (square / 8)))) | ((FILE_A | FILE_H) & ~(FILE_A << (square % 8)));
+
+            entry.mask = slidingAttacks(square, EMPTY_BITBOARD, directions) & ~edges;
+            entry.shift = 64 - popCount(entry.mask);
+            entry.attacks = attacks;
+            entry.magic = 0;
+
+            // enumerate all the subsets of the mask (Carry-Rippler trick)
+            int size = 0;
+            Bitboard occupied = EMPTY_BITBOARD;
+
+            do {
+                occupancies[size] = occupied;
+                reference[size] = slidingAttacks(square, occupied, directions);
+
+                if (USE_PEXT) {
+                    attacks[pextIndex(occupied, entry.mask)] = reference[size];
+                }
+
+                ++size;
+                occupied = (occupied - entry.mask) & entry.mask;
+            } while (occupied);
+
+            attacks += size;
+
+            if (USE_PEXT) {
+                continue;
+            }
+
+            MagicRandom random(seeds[square / 8]);
+
+            for (int i = 0; i < size; ) {
+                do {
+                    entry.magic = random.sparse();
+                } while (popCount((entry.magic * entry.mask) >> 56) < 6);
+
+                // a magic fits if every occupancy maps either to an unused slot or to a slot with the same attacks
+                ++attempt;
+
+                for (i = 0; i < size; ++i) {
+                    auto index = entry.index(occupancies[i]);
+
+                    if (epoch[index] < attempt) {
+                        epoch[index] = attempt;
+                        entry.attacks[index] = reference[i];
+                    }
+                    else if (entry.attacks[index] != reference[i]) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("bmi2")))
+#endif
+unsigned int pextIndex(Bitboard occupied, Bitboard mask) {
+    return static_cast<unsigned int>(_pext_u64(occupied, mask));
+}
+#else
+unsigned int pextIndex(Bitboard occupied, Bitboard mask) {
+    // software PEXT; never used for lookups as `hasPextSupport()` is false on this platform
+    unsigned int result = 0;
+
+    for (unsigned int bit = 1; mask; bit <<= 1) {
+        if (occupied & mask & (~mask + 1)) {
+            result |= bit;
+        }
+
+        mask &= mask - 1;
+    }
+
+    return result;
+}
+#endif
+
+bool hasPextSupport() {
+#if defined(__BMI2__)
+    return true;
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("bmi2");
+#elif defined(_M_X64)
+    int registers[4];
+    __cpuidex(registers, 7, 0);
+    return (registers[1] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+void initAttacks() {
+    static std::once_flag initialized;
+
+    std::call_once(initialized, []() {
+        USE_PEXT = hasPextSupport();
+
+        initSlidingAttacks(ROOK_ATTACKS, rookTable.data(), ROOK_DIRECTIONS);
+        initSlidingAttacks(BISHOP_ATTACKS, bishopTable.data(), BISHOP_DIRECTIONS);
+    });
+}
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+
+#include "chesslib/Fen.hpp"
+
+namespace {
+    // `PackedPosition` piece code of a FEN piece letter, 0 for any other character
+    constexpr std::array<std::uint8_t, 256> PIECE_CODES = [] {
+        std::array<std::uint8_t, 256> codes{};
+
+        for (auto piece : { WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING,
+                            BLACK_PAWN, BLACK_KNIGHT, BLACK_BISHOP, BLACK_ROOK, BLACK_QUEEN, BLACK_KING }) {
+            codes[static_cast<unsigned char>(piece)] = static_cast<std::uint8_t>(pieceIndex(piece) + 1);
+        }
+
+        return codes;
+    }();
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) {
+            text.remove_prefix(1);
+        }
+
+        while (!text.empty() && isSpace(text.back())) {
+            text.remove_suffix(1);
+        }
+
+        return text;
+    }
+
+    // cuts the next space separated field off the front of the text
+    std::string_view nextField(std::string_view& text) {
+        auto end = text.find(' ');
+        auto field = text.substr(0, end);
+
+        text = (end == std::string_view::npos) ? std::string_view() : text.substr(end + 1);
+
+        return field;
+    }
+
+    bool parseCounter(std::string_view field, std::uint16_t& value) {
+        auto [ptr, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+
+        return !field.empty() && error == std::errc() && ptr == field.data() + field.size();
+    }
+
+    bool parsePiecePlacement(std::string_view field, PackedPosition& position) {
+        int rank = 7;
+        int file = 0;
+
+        for (auto c : field) {
+            if (c == '/') {
+                if (file != 8 || rank == 0) {
+                    return false;
+                }
+
+                --rank;
+                file = 0;
+            }
+            else if (c >= '1' && c <= '8') {
+                file += c - '0';
+
+                if (file > 8) {
+                    return false;
+                }
+            }
+            else {
+                auto code = PIECE_CODES[static_cast<unsigned char>(c)];
+
+                if (code == 0 || file >= 8) {
+                    return false;
+                }
+
+                auto index = rank * 8 + file;
+
+                position.pieces[index >> 1] |= static_cast<std::uint8_t>(code << ((index & 1) * 4));
+                ++file;
+            }
+        }
+
+        return rank == 0 && file == 8;
+    }
+
+    // one king for the side to move, at most one for the other (lone king studies have none) and no pawn on the first
+    // or last rank, which the move generator takes for granted
+    bool isValidPosition(const PackedPosition& position, PieceColor sideToMove) {
+        std::array<int, 2> kings{ 0, 0 };
+
+        for (int index = 0; index < 64; ++index) {
+            auto piece = position.pieceAt(Square(index));
+
+            if (piece == NONE) {
+                continue;
+            }
+
+            if (pieceType(piece) == KING) {
+                ++kings[colorIndex(pieceColor(piece))];
+            }
+            else if (pieceType(piece) == PAWN && (index < 8 || index >= 56)) {
+                return false;
+            }
+        }
+
+        return kings[colorIndex(sideToMove)] == 1 && kings[colorIndex(opponentColor(sideToMove))] <= 1;
+    }
+
+    bool parseCastlingRights(std::string_view field, PackedPosition& position) {
+        if (field == "-") {
+            return true;
+        }
+
+        if (field.empty() || field.size() > 4) {
+            return false;
+        }
+
+        for (auto c : field) {
+            std::uint8_t right = (c == 'K') ? WHITE_KING_SIDE_CASTLING :
+                (c == 'Q') ? WHITE_QUEEN_SIDE_CASTLING :
+                (c == 'k') ? BLACK_KING_SIDE_CASTLING :
+                (c == 'q') ? BLACK_QUEEN_SIDE_CASTLING :
+                NO_CASTLING;
+
+            if (right == NO_CASTLING || (position.castlingRights & right)) {
+                return false;
+            }
+
+            position.castlingRights |= right;
+        }
+
+        // a right is kept only while the king and the rook it needs are both at home
+        struct CastlingPieces {
+            CastlingRights right;
+            Piece king;
+            Square kingSquare;
+            Piece rook;
+            Square rookSquare;
+        };
+
+        constexpr std::array<CastlingPieces, 4> castlingPieces{
+            {
+                { WHITE_KING_SIDE_CASTLING, WHITE_KING, Square::fromFileRank(4, 0), WHITE_ROOK, Square::fromFileRank(7, 0) },
+                { WHITE_QUEEN_SIDE_CASTLING, WHITE_KING, Square::fromFileRank(4, 0), WHITE_ROOK, Square::fromFileRank(0, 0) },
+                { BLACK_KING_SIDE_CASTLING, BLACK_KING, Square::fromFileRank(4, 7), BLACK_ROOK, Square::fromFileRank(7, 7) },
+                { BLACK_QUEEN_SIDE_CASTLING, BLACK_KING, Square::fromFileRank(4, 7), BLACK_ROOK, Square::fromFileRank(0, 7) }
+            }
+        };
+
+        for (const auto& pieces : castlingPieces) {
+            if (position.pieceAt(pieces.kingSquare) != pieces.king || position.pieceAt(pieces.rookSquare) != pieces.rook) {
+                position.castlingRights &= static_cast<std::uint8_t>(~pieces.right);
+            }
+        }
+
+        return true;
+    }
+
+    bool parseEnPassantTarget(std::string_view field, PackedPosition& position) {
+        if (field == "-") {
+            return true;
+        }
+
+        auto target = Square::fromAlgebraic(field);
+
+        // the square a pawn of the side which has just moved skipped
+        auto targetRank = (position.currentPlayer == WHITE) ? 5 : 2;
+
+        if (field.size() != 2 || !target.has_value() || target->rank() != targetRank) {
+            return false;
+        }
+
+        auto pawnSquare = (position.currentPlayer == WHITE) ? *target - 8 : *target + 8;
+
+        if (position.pieceAt(pawnSquare) == makePiece(opponentColor(position.currentPlayer), PAWN)) {
+            position.enPassantTarget = static_cast<std::uint8_t>(target->index());
+        }
+
+        return true;
+    }
+
+    // the FEN of the position at `out`, which has room for `MAX_FEN_LENGTH` characters; returns the end of it
+    char* writeFEN(const PackedPosition& position, char* out) {
+        for (int rank = 7; rank >= 0; --rank) {
+            char empty = 0;
+
+            for (int file = 0; file < 8; ++file) {
+                auto piece = position.pieceAt(Square::fromFileRank(file, rank));
+
+                if (piece == NONE) {
+                    ++empty;
+                    continue;
+                }
+
+                if (empty > 0) {
+                    *out++ = static_cast<char>('0' + empty);
+                    empty = 0;
+                }
+
+                *out++ = static_cast<char>(piece);
+            }
+
+            if (empty > 0) {
+                *out++ = static_cast<char>('0' + empty);
+            }
+
+            if (rank > 0) {
+                *out++ = '/';
+            }
+        }
+
+        *out++ = ' ';
+        *out++ = static_cast<char>(position.currentPlayer);
+        *out++ = ' ';
+
+        if (position.castlingRights == NO_CASTLING) {
+            *out++ = '-';
+        }
+        else {
+            constexpr char symbols[] = { 'K', 'Q', 'k', 'q' };
+
+            for (int right = 0; right < 4; ++right) {
+                if (position.castlingRights & (1 << right)) {
+                    *out++ = symbols[right];
+                }
+            }
+        }
+
+        *out++ = ' ';
+
+        if (auto target = position.enPassantSquare(); target.has_value()) {
+            *out++ = target->fileSymbol();
+            *out++ = target->rankSymbol();
+        }
+        else {
+            *out++ = '-';
+        }
+
+        *out++ = ' ';
+        out = std::to_chars(out, out + 5, position.halfmoveClock).ptr;
+        *out++ = ' ';
+        out = std::to_chars(out, out + 5, position.fullmoveNumber).ptr;
+
+        return out;
+    }
+}
+
+std::string_view fenErrorMessage(FenError error) {
+    switch (error) {
+    case MISSING_FIELD:
+        return "missing field";
+
+    case INVALID_PIECE_PLACEMENT:
+        return "invalid piece placement";
+
+    case INVALID_POSITION:
+        return "invalid position";
+
+    case INVALID_SIDE_TO_MOVE:
+        return "invalid side to move";
+
+    case INVALID_CASTLING_RIGHTS:
+        return "invalid castling rights";
+
+    case INVALID_EN_PASSANT_TARGET:
+        return "invalid en passant target";
+
+    case INVALID_HALFMOVE_CLOCK:
+        return "invalid halfmove clock";
+
+    case INVALID_FULLMOVE_NUMBER:
+        return "invalid fullmove number";
+
+    case TRAILING_CHARACTERS:
+        return "trailing characters";
+    }
+
+    return "unknown error";
+}
+
+std::expected<PackedPosition, FenError> parseFENPosition(std::string_view fen) {
+    PackedPosition position;
+
+    auto rest = trim(fen);
+
+    if (!parsePiecePlacement(nextField(rest), position)) {
+        return std::unexpected(INVALID_PIECE_PLACEMENT);
+    }
+
+    if (rest.empty()) {
+        return std::unexpected(MISSING_FIELD);
+    }
+
+    auto side = nextField(rest);
+
+    if (side != "w" && side != "b") {
+        return std::unexpected(INVALID_SIDE_TO_MOVE);
+    }
+
+    position.currentPlayer = (side == "b") ? BLACK : WHITE;
+
+    if (!isValidPosition(position, position.currentPlayer)) {
+        return std::unexpected(INVALID_POSITION);
+    }
+
+    if (rest.empty()) {
+        return std::unexpected(MISSING_FIELD);
+    }
+
+    if (!parseCastlingRights(nextField(rest), position)) {
+        return std::unexpected(INVALID_CASTLING_RIGHTS);
+    }
+
+    if (rest.empty()) {
+        return std::unexpected(MISSING_FIELD);
+    }
+
+    if (!parseEnPassantTarget(nextField(rest), position)) {
+        return std::unexpected(INVALID_EN_PASSANT_TARGET);
+    }
+
+    if (!rest.empty() && !parseCounter(nextField(rest), position.halfmoveClock)) {
+        return std::unexpected(INVALID_HALFMOVE_CLOCK);
+    }
+
+    if (!rest.empty()) {
+        // plenty of FENs in the wild number the moves from 0
+        if (!parseCounter(nextField(rest), position.fullmoveNumber)) {
+            return std::unexpected(INVALID_FULLMOVE_NUMBER);
+        }
+
+        position.fullmoveNumber = std::max<std::uint16_t>(position.fullmoveNumber, 1);
+    }
+
+    if (!rest.empty()) {
+        return std::unexpected(TRAILING_CHARACTERS);
+    }
+
+    return position;
+}
+
+FenBatchResult parseFENBatch(std::span<const char> buffer, std::span<PackedPosition> positions) {
+    FenBatchResult result{ .positions = 0, .errors = 0, .consumed = 0 };
+
+    std::string_view text(buffer.data(), buffer.size());
+
+    while (result.consumed < text.size() && result.positions < positions.size()) {
+        auto lineEnd = text.find('\n', result.consumed);
+
+        // the last line does not need a line break after it
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = text.size();
+        }
+
+        auto line = trim(text.substr(result.consumed, lineEnd - result.consumed));
+
+        result.consumed = std::min(lineEnd + 1, text.size());
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (auto position = parseFENPosition(line); position.has_value()) {
+            positions[result.positions++] = *position;
+        }
+        else {
+            ++result.errors;
+        }
+    }
+
+    return result;
+}
+
+std::size_t serializeFENPosition(const PackedPosition& position, std::span<char> buffer) {
+    if (buffer.size() >= MAX_FEN_LENGTH) {
+        return static_cast<std::size_t>(writeFEN(position, buffer.data()) - buffer.data());
+    }
+
+    // most FENs are much shorter than the longest possible one, so a small buffer is tried through a scratch one
+    char scratch[MAX_FEN_LENGTH];
+    auto length = static_cast<std::size_t>(writeFEN(position, scratch) - scratch);
+
+    if (length > buffer.size()) {
+        return 0;
+    }
+
+    std::memcpy(buffer.data(), scratch, length);
+
+    return length;
+}
+
+FenSerializeResult serializeFENBatch(std::span<const PackedPosition> positions, std::span<char> buffer) {
+    FenSerializeResult result{ .positions = 0, .written = 0 };
+
+    for (const auto& position : positions) {
+        auto rest = buffer.subspan(result.written);
+        auto length = serializeFENPosition(position, rest);
+
+        if (length == 0 || length == rest.size()) {
+            break;
+        }
+
+        rest[length] = '\n';
+
+        result.written += length + 1;
+        ++result.positions;
+    }
+
+    return result;
+}
@@ -1,9 +1,42 @@
+#include <algorithm>
+
 #include "chesslib/Game.hpp"
+#include "chesslib/Attacks.hpp"
+
+namespace {
+    // rights kept by a move from or to the square: moving the king or a rook from its original square (or capturing
+    // a rook on one) loses them, so `makeMove()` updates the mask with two lookups instead of testing the squares
+    constexpr std::array<std::uint8_t, 64> CASTLING_RIGHTS_KEPT = [] {
+        std::array<std::uint8_t, 64> kept{};
+
+        kept.fill(ALL_CASTLING);
+
+        kept[makeSquare(1, 'e').index()] = ALL_CASTLING & ~(WHITE_KING_SIDE_CASTLING | WHITE_QUEEN_SIDE_CASTLING);
+        kept[makeSquare(1, 'h').index()] = ALL_CASTLING & ~WHITE_KING_SIDE_CASTLING;
+        kept[makeSquare(1, 'a').index()] = ALL_CASTLING & ~WHITE_QUEEN_SIDE_CASTLING;
+
+        kept[makeSquare(8, 'e').index()] = ALL_CASTLING & ~(BLACK_KING_SIDE_CASTLING | BLACK_QUEEN_SIDE_CASTLING);
+        kept[makeSquare(8, 'h').index()] = ALL_CASTLING & ~BLACK_KING_SIDE_CASTLING;
+        kept[makeSquare(8, 'a').index()] = ALL_CASTLING & ~BLACK_QUEEN_SIDE_CASTLING;
+
+        return kept;
+    }();
+
+    // longer games still work, they just reallocate the history once in a while
+    constexpr std::size_t RESERVED_PLIES = 256;
+}
 
 Game::Game() :
-    castlingAvailability{ false, false, false, false },
-    currentPlayer(WHITE)
+    currentPlayer(WHITE),
+    castlingRights(NO_CASTLING),
+    halfmoveClock(0),
+    fullmoveNumber(1)
 {
+    initAttacks();
+
+    moveHistory.reserve(RESERVED_PLIES);
+    undoStack.reserve(RESERVED_PLIES);
+
     std::array<std::array<Piece, 8>, 8> standardBoard{
         {
             { WHITE_ROOK, WHITE_KNIGHT, WHITE_BISHOP, WHITE_QUEEN, WHITE_KING, WHITE_BISHOP, WHITE_KNIGHT, WHITE_ROOK },
@@ -17,175 +50,79 @@ Game::Game() :
         }
     };
 
-    pieces = standardBoard;
-}
-
-void Game::parseFEN(const std::string& fenString) {
-    auto boardStringEnd = fenString.find(' ');
-
-    // parse first part of the FEN string - board state
-    std::array<std::array<Piece, 8>, 8> board{ { NONE } };
-
-    int currentRow = 7;
-    int currentCol = 0;
-
-    for (auto i = 0; i < boardStringEnd; ++i) {
-        switch (fenString.at(i)) {
-        case '/':
-            --currentRow;
-            currentCol = 0;
-            break;
-
-        case 'r':
-            board[currentRow][currentCol++] = BLACK_ROOK;
-            break;
-
-        case 'n':
-            board[currentRow][currentCol++] = BLACK_KNIGHT;
-            break;
-
-        case 'b':
-            board[currentRow][currentCol++] = BLACK_BISHOP;
-            break;
-
-        case 'k':
-            board[currentRow][currentCol++] = BLACK_KING;
-            break;
-
-        case 'q':
-            board[currentRow][currentCol++] = BLACK_QUEEN;
-            break;
-
-        case 'p':
-            board[currentRow][currentCol++] = BLACK_PAWN;
-            break;
-
-        case 'R':
-            board[currentRow][currentCol++] = WHITE_ROOK;
-            break;
-
-        case 'N':
-            board[currentRow][currentCol++] = WHITE_KNIGHT;
-            break;
-
-        case 'B':
-            board[currentRow][currentCol++] = WHITE_BISHOP;
-            break;
-
-        case 'K':
-            board[currentRow][currentCol++] = WHITE_KING;
-            break;
-
-        case 'Q':
-            board[currentRow][currentCol++] = WHITE_QUEEN;
-            break;
+    clearBoard();
 
-        case 'P':
-            board[currentRow][currentCol++] = WHITE_PAWN;
-            break;
-
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-            currentCol += static_cast<int>(fenString.at(i)) - static_cast<int>('1') + 1;
-            break;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            setPieceAt(Square::fromFileRank(col, row), standardBoard[row][col]);
         }
     }
 
-    pieces = board;
+    positionKey = computeHash();
+}
 
-    // parse second part of FEN string - current player
-    auto currentPlayerStringEnd = fenString.find(' ', boardStringEnd + 1);
+std::expected<void, FenError> Game::parseFEN(std::string_view fenString) {
+    auto position = parseFENPosition(fenString);
 
-    currentPlayer = (fenString.at(boardStringEnd + 1) == 'b') ? BLACK : WHITE;
+    if (!position.has_value()) {
+        return std::unexpected(position.error());
+    }
 
-    // parse third part of FEN string - castling availability
-    auto castlingAvailabilityStringEnd = fenString.find(' ', currentPlayerStringEnd + 1);
+    loadPosition(*position);
 
-    castlingAvailability = CastlingAvailability{ false };
+    return {};
+}
 
-    for (int i = currentPlayerStringEnd + 1; i < castlingAvailabilityStringEnd; ++i) {
-        if (fenString.at(i) == '-') {
-            break;
-        }
+void Game::loadPosition(const PackedPosition& position) {
+    clearBoard();
 
-        switch (fenString.at(i)) {
-        case 'K':
-            castlingAvailability.WHITE_KING_SIDE = true;
-            break;
+    // the board is empty already, so only the pieces go through `setPieceAt()`
+    for (int index = 0; index < 64; ++index) {
+        if (auto piece = position.pieceAt(Square(index)); piece != NONE) {
+            setPieceAt(Square(index), piece);
+        }
+    }
 
-        case 'Q':
-            castlingAvailability.WHITE_QUEEN_SIDE = true;
-            break;
+    currentPlayer = position.currentPlayer;
+    castlingRights = position.castlingRights;
+    enPassantTarget = position.enPassantSquare();
+    halfmoveClock = position.halfmoveClock;
+    fullmoveNumber = position.fullmoveNumber;
 
-        case 'k':
-            castlingAvailability.BLACK_KING_SIDE = true;
-            break;
+    // moves made before do not lead to the new position
+    moveHistory.clear();
+    undoStack.clear();
 
-        case 'q':
-            castlingAvailability.BLACK_QUEEN_SIDE = true;
-            break;
-        }
-    }
+    positionKey = computeHash();
+    pawnKey = computePawnHash();
 }
 
 std::string Game::serializeAsFEN() const {
-    std::string boardString = "";
-
-    // board state block
-    for (int i = 7; i >= 0; --i) {
-        int contiguousEmpty = 0;
-
-        for (int t = 0; t < 8; ++t) {
-            if (pieces[i][t] == NONE) {
-                ++contiguousEmpty;
-                continue;
-            }
+    char buffer[MAX_FEN_LENGTH];
 
-            if (pieces[i][t] != NONE && contiguousEmpty > 0) {
-                boardString += static_cast<char>(static_cast<int>('1') + contiguousEmpty - 1);
-                contiguousEmpty = 0;
-            }
+    return std::string(buffer, serializeAsFEN(buffer));
+}
 
-            boardString += static_cast<char>(pieces[i][t]);
-        }
+std::size_t Game::serializeAsFEN(std::span<char> buffer) const {
+    return serializeFENPosition(packPosition(), buffer);
+}
 
-        if (contiguousEmpty > 0) {
-            boardString += static_cast<char>(static_cast<int>('1') + contiguousEmpty - 1);
-        }
+PackedPosition Game::packPosition() const {
+    PackedPosition position;
 
-        if (i > 0) {
-            boardString += '/';
-        }
+    for (int index = 0; index < 64; ++index) {
+        position.setPieceAt(Square(index), board[index]);
     }
 
-    std::string castlingString = "";
-
-    if (castlingAvailability.WHITE_KING_SIDE)
-        castlingString += 'K';
-
-    if (castlingAvailability.WHITE_QUEEN_SIDE)
-        castlingString += 'Q';
-
-    if (castlingAvailability.BLACK_KING_SIDE)
-        castlingString += 'k';
-
-    if (castlingAvailability.BLACK_QUEEN_SIDE)
-        castlingString += 'q';
-
-    if (castlingString.empty())
-        castlingString = "-";
+    position.currentPlayer = currentPlayer;
+    position.castlingRights = castlingRights;
+    position.enPassantTarget = enPassantTarget.has_value() ? static_cast<std::uint8_t>(enPassantTarget->index()) : PackedPosition::NO_EN_PASSANT;
 
-    std::string enPassantString = "-";
+    // the packed counters are 16-bit, as the FEN parser reads them
+    position.halfmoveClock = static_cast<std::uint16_t>(std::min(halfmoveClock, 65535u));
+    position.fullmoveNumber = static_cast<std::uint16_t>(std::min(fullmoveNumber, 65535u));
 
-    std::string result = std::format("{0} {1} {2} {3} {4} {5}", boardString, static_cast<char>(currentPlayer), castlingString, enPassantString, 0, (moveHistory.size() / 2) + 1);
-
-    return result;
+    return position;
 }
 
 Piece Game::parsePiece(char pieceSymbol) const {
@@ -210,664 +147,609 @@ Piece Game::parsePiece(char pieceSymbol) const {
     }
 }
 
-std::optional<Move> Game::parseMove(const std::string& moveString) const {
-    Move move{
-        .piece = NONE,
-        .from = {.row = 9, .col = 9 },
-        .to = { .row = 9, .col = 9 },
-        .promotion = std::nullopt,
-        .isCapture = false,
-        .isCastling = false
-    };
+std::optional<Move> Game::parseMove(std::string_view moveString) const {
+    auto move = parsePackedMove(moveString);
 
-    if (moveString == "O-O" || moveString == "0-0") {
-        move.isCastling = true;
+    if (!move.has_value()) {
+        return std::nullopt;
+    }
 
-        if (currentPlayer == WHITE) {
-            move.piece = WHITE_KING;
-            move.to = { .row = 1, .col = static_cast<int>('g') };
-        }
-        else {
-            move.piece = BLACK_KING;
-            move.to = { .row = 8, .col = static_cast<int>('g') };
-        }
+    return unpackMove(*move);
+}
+
+std::optional<PackedMove> Game::parsePackedMove(std::string_view moveString) const {
+    // ignore notation: # - checkmate, + - check, ! - a very good move, !! - a brilliant move, !? - interesting move, ?! - dubious move, ? - bad move, ?? - blunder
+    while (!moveString.empty() && (moveString.back() == '+' || moveString.back() == '#' || moveString.back() == '!' || moveString.back() == '?')) {
+        moveString.remove_suffix(1);
     }
-    else if (moveString == "O-O-O" || moveString == "0-0-0") {
-        move.isCastling = true;
 
-        if (currentPlayer == WHITE) {
-            move.piece = WHITE_KING;
-            move.to = { .row = 1, .col = static_cast<int>('b') };
-        }
-        else {
-            move.piece = BLACK_KING;
-            move.to = { .row = 8, .col = static_cast<int>('b') };
-        }
+    // what the notation tells about the move; the legal move it describes has to be the only one matching all of it
+    auto movingType = PAWN;
+    std::optional<PieceType> promotion = std::nullopt;
+    std::optional<MoveFlag> castling = std::nullopt;
+    int fromFile = -1;
+    int fromRank = -1;
+    Square to;
+
+    if (moveString == "O-O" || moveString == "0-0") {
+        castling = KING_SIDE_CASTLING;
+    }
+    else if (moveString == "O-O-O" || moveString == "0-0-0") {
+        castling = QUEEN_SIDE_CASTLING;
     }
     else {
-        move.piece = parsePiece(moveString.at(0));
+        switch (moveString.empty() ? '\0' : moveString.front()) {
+        case 'N':
+            movingType = KNIGHT;
+            break;
 
-        if (moveString.find('x') != std::string::npos) {
-            move.isCapture = true;
+        case 'B':
+            movingType = BISHOP;
+            break;
+
+        case 'R':
+            movingType = ROOK;
+            break;
+
+        case 'Q':
+            movingType = QUEEN;
+            break;
 
-            move.to.parse(moveString.substr(moveString.find('x') + 1));
+        case 'K':
+            movingType = KING;
+            break;
         }
-        else if ((move.piece == WHITE_PAWN || move.piece == BLACK_PAWN) && moveString.find('=') != std::string::npos) {
-            move.promotion = parsePiece(moveString.at(3));
+
+        if (movingType != PAWN) {
+            moveString.remove_prefix(1);
         }
-        else {
-            // ignore notation: # - checkmate, + - check, ! - a very good move, !! - a brilliant move, !? - interesting move, ?! - dubious move, ? - bad move, ?? - blunder
-            int positionStringEnd = moveString.length() - 1;
 
-            while (!std::isalnum(moveString.at(positionStringEnd))) {
-                --positionStringEnd;
-            }
+        // promotion, either `e8=Q` or `e8Q`
+        if (movingType == PAWN && !moveString.empty()) {
+            switch (moveString.back()) {
+            case 'N':
+            case 'n':
+                promotion = KNIGHT;
+                break;
 
-            move.to.parse(moveString.substr(positionStringEnd - 1));
-        }
-    }
+            case 'B':
+            case 'b':
+                promotion = BISHOP;
+                break;
 
-    std::vector<Position> fromCandidates;
-    Move candidateMove = move;
+            case 'R':
+            case 'r':
+                promotion = ROOK;
+                break;
 
-    if (move.piece == WHITE_KING || move.piece == BLACK_KING) {
-        std::map<Move, bool, MoveComparator> cache{};
+            case 'Q':
+            case 'q':
+                promotion = QUEEN;
+                break;
+            }
 
-        for (unsigned int row = 1; row <= 8; ++row) {
-            for (auto col = static_cast<int>('a'); col <= static_cast<int>('h'); ++col) {
-                candidateMove.from = Position{ .row = row, .col = static_cast<char>(col) };
+            if (promotion.has_value()) {
+                moveString.remove_suffix(1);
 
-                if (pieceAt(candidateMove.from) == move.piece) {
-                    if (isValidMove(candidateMove, cache, currentPlayer))
-                        fromCandidates.push_back(candidateMove.from);
+                if (!moveString.empty() && moveString.back() == '=') {
+                    moveString.remove_suffix(1);
                 }
             }
         }
-    } else {
-        for (unsigned int row = 1; row <= 8; ++row) {
-            for (auto col = static_cast<int>('a'); col <= static_cast<int>('h'); ++col) {
-                candidateMove.from = Position{ .row = row, .col = static_cast<char>(col) };
 
-                if (pieceAt(candidateMove.from) == move.piece) {
-                    if (isValidMove(candidateMove))
-                        fromCandidates.push_back(candidateMove.from);
-                }
-            }
+        if (moveString.size() < 2) {
+            return std::nullopt;
         }
-    }
 
-    if (fromCandidates.size() == 0) {
-        return std::nullopt;
-    }
-    else if (fromCandidates.size() == 1) {
-        move.from = fromCandidates.at(0);
-    }
-    else {
-        // resolve ambiguous moves
-        if (move.piece == WHITE_PAWN || move.piece == BLACK_PAWN) {
-            // two pawns can only have same target position if they are on the same row, but different columns
-            // hence first character of the `moveString` would identify the column
-            char col = moveString.at(0);
+        auto target = Square::fromAlgebraic(moveString.substr(moveString.size() - 2));
 
-            auto position = std::find_if(fromCandidates.begin(), fromCandidates.end(), [col](auto p) { return p.col == col; });
+        if (!target.has_value()) {
+            return std::nullopt;
+        }
+
+        to = *target;
+        moveString.remove_suffix(2);
 
-            if (position == fromCandidates.end()) {
-                // impossible?!
+        // whatever is left is the disambiguation (a file, a rank or both) and the capture mark, which the move list
+        // already knows about; long notation (`Ng1-f3`) passes as well
+        for (auto c : moveString) {
+            if (c >= 'a' && c <= 'h') {
+                fromFile = c - 'a';
+            }
+            else if (c >= '1' && c <= '8') {
+                fromRank = c - '1';
+            }
+            else if (c != 'x' && c != ':' && c != '-') {
                 return std::nullopt;
             }
-
-            move.from = *position;
         }
-        else {
-            // hence first character of the `moveString` after the piece character would identify the column __or__ the row
-            char ch = moveString.at(1);
+    }
 
-            if (std::isdigit(ch)) {
-                // search for pieces by the row
-                auto row = static_cast<int>(ch) - static_cast<int>('a') + 1;
-                auto position = std::find_if(fromCandidates.begin(), fromCandidates.end(), [row](auto p) { return p.row == row; });
+    MoveList moves;
+    generateLegalMoves(moves);
 
-                if (position == fromCandidates.end()) {
-                    // impossible?!
-                    return std::nullopt;
-                }
+    std::optional<PackedMove> found = std::nullopt;
 
-                move.from = *position;
-            }
-            else if (std::isalpha(ch)) {
-                // search for pieces by the column
-                auto position = std::find_if(fromCandidates.begin(), fromCandidates.end(), [ch](auto p) { return p.col == ch; });
+    for (auto move : moves) {
+        bool matches;
 
-                if (position == fromCandidates.end()) {
-                    // impossible?!
-                    return std::nullopt;
-                }
+        if (castling.has_value()) {
+            matches = move.flags() == *castling;
+        }
+        else {
+            auto from = move.from();
 
-                move.from = *position;
-            }
-            else {
+            matches = move.to() == to &&
+                pieceType(board[from.index()]) == movingType &&
+                !move.isCastling() &&
+                (fromFile < 0 || from.file() == fromFile) &&
+                (fromRank < 0 || from.rank() == fromRank) &&
+                move.isPromotion() == promotion.has_value() &&
+                (!promotion.has_value() || move.promotionType() == *promotion);
+        }
+
+        if (matches) {
+            // an ambiguous move does not pick any of the candidates
+            if (found.has_value()) {
                 return std::nullopt;
             }
+
+            found = move;
         }
     }
 
-    return move;
-}
-
-std::string Game::serializeMove(const Move move) const {
-    // TODO: implement
-    return "";
+    return found;
 }
 
 Piece Game::pieceAt(int row, char col) const {
-    return pieces[row - 1][static_cast<int>(col) - 'a'];
+    return board[makeSquare(row, col).index()];
 }
 
 Piece Game::pieceAt(const Position pos) const {
-    return pieces[pos.row - 1][static_cast<int>(pos.col) - 'a'];
+    return board[pos.square().index()];
+}
+
+Piece Game::pieceAt(Square square) const {
+    return board[square.index()];
 }
 
 void Game::setPieceAt(int row, char col, const Piece piece) {
-    pieces[row - 1][static_cast<int>(col) - 'a'] = piece;
+    setPieceAt(makeSquare(row, col), piece);
 }
 
 void Game::setPieceAt(const Position pos, const Piece piece) {
-    pieces[pos.row - 1][static_cast<int>(pos.col) - 'a'] = piece;
+    setPieceAt(pos.square(), piece);
 }
 
-void Game::movePiece(Position from, Position to) {
-    auto piece = pieceAt(from.row, from.col);
+void Game::setPieceAt(Square square, const Piece piece) {
+    auto bit = squareBit(square);
+    auto previous = board[square.index()];
 
-    setPieceAt(from.row, from.col, NONE);
-    setPieceAt(to.row, to.col, piece);
-}
+    attackMapsValid = false;
+    validityTableValid = false;
+    checkInfoValid = false;
 
-bool Game::opponentPieceAt(const Position pos) const {
-    return opponentPieceAt(pos, currentPlayer);
-}
+    if (previous != NONE) {
+        pieceBitboards[pieceIndex(previous)] &= ~bit;
+        colorBitboards[colorIndex(pieceColor(previous))] &= ~bit;
+        occupied &= ~bit;
 
-bool Game::opponentPieceAt(const Position pos, const PieceColor currentPlayerColor) const {
-    auto piece = pieceAt(pos);
+        positionKey ^= ZOBRIST.pieces[pieceIndex(previous)][square.index()];
 
-    if (currentPlayerColor == WHITE) {
-        return piece == BLACK_ROOK ||
-            piece == BLACK_KNIGHT ||
-            piece == BLACK_BISHOP ||
-            piece == BLACK_KING ||
-            piece == BLACK_QUEEN ||
-            piece == BLACK_PAWN;
-    }
-    else {
-        return piece == WHITE_ROOK ||
-            piece == WHITE_KNIGHT ||
-            piece == WHITE_BISHOP ||
-            piece == WHITE_KING ||
-            piece == WHITE_QUEEN ||
-            piece == WHITE_PAWN;
+        if (pieceType(previous) == PAWN) {
+            pawnKey ^= ZOBRIST.pieces[pieceIndex(previous)][square.index()];
+        }
+
+        evaluator.removePiece(previous, square);
     }
-}
 
-bool Game::allyPieceAt(const Position pos) const {
-    return allyPieceAt(pos, currentPlayer);
-}
+    if (piece != NONE) {
+        pieceBitboards[pieceIndex(piece)] |= bit;
+        colorBitboards[colorIndex(pieceColor(piece))] |= bit;
+        occupied |= bit;
 
-bool Game::allyPieceAt(const Position pos, const PieceColor currentPlayerColor) const {
-    auto piece = pieceAt(pos);
+        positionKey ^= ZOBRIST.pieces[pieceIndex(piece)][square.index()];
+
+        if (pieceType(piece) == PAWN) {
+            pawnKey ^= ZOBRIST.pieces[pieceIndex(piece)][square.index()];
+        }
 
-    if (currentPlayerColor == BLACK) {
-        return piece == BLACK_ROOK ||
-            piece == BLACK_KNIGHT ||
-            piece == BLACK_BISHOP ||
-            piece == BLACK_KING ||
-            piece == BLACK_QUEEN ||
-            piece == BLACK_PAWN;
+        evaluator.addPiece(piece, square);
     }
-    else {
-        return piece == WHITE_ROOK ||
-            piece == WHITE_KNIGHT ||
-            piece == WHITE_BISHOP ||
-            piece == WHITE_KING ||
-            piece == WHITE_QUEEN ||
-            piece == WHITE_PAWN;
+
+    board[square.index()] = piece;
+
+    if (network) {
+        updateAccumulator(previous, piece, square);
     }
 }
 
-bool Game::canOpponentMoveTo(const Position pos) const {
-    std::map<Move, bool, MoveComparator> cache{};
+void Game::updateAccumulator(Piece previous, Piece piece, Square square) {
+    for (auto perspective : { WHITE, BLACK }) {
+        auto side = colorIndex(perspective);
 
-    return canOpponentMoveTo(pos, cache, currentPlayer);
-}
+        if (!accumulator.computed[side]) {
+            continue;
+        }
 
-bool Game::canOpponentMoveTo(const Position pos, std::map<Move, bool, MoveComparator>& cache, const PieceColor currentPlayerColor) const {
-    for (unsigned int row = 1; row < 8; ++row) {
-        for (char col = static_cast<int>('a'); col < static_cast<int>('h'); ++col) {
-            auto tmpPos = Position{ .row = row, .col = static_cast<char>(col) };
+        // every input of a side hangs on the square of its king, moving it takes a refresh; the other king is no input
+        auto ownKing = makePiece(perspective, KING);
 
-            if (opponentPieceAt(tmpPos, currentPlayerColor)) {
-                auto piece = pieceAt(tmpPos);
+        if (previous == ownKing || piece == ownKing) {
+            accumulator.computed[side] = false;
+            continue;
+        }
 
-                auto move = Move{ .piece = piece, .from = tmpPos, .to = pos };
+        auto kingSquare = lsb(pieceBitboards[side * 6 + KING]);
 
-                if (allyPieceAt(pos, currentPlayerColor)) {
-                    move.isCapture = true;
-                }
+        if (previous != NONE && pieceType(previous) != KING) {
+            network->removeFeature(accumulator, perspective, Network::featureIndex(perspective, kingSquare, previous, square));
+        }
 
-                if (isValidMove(move, cache, currentPlayerColor == WHITE ? BLACK : WHITE)) {
-                    return true;
-                }
-            }
+        if (piece != NONE && pieceType(piece) != KING) {
+            network->addFeature(accumulator, perspective, Network::featureIndex(perspective, kingSquare, piece, square));
         }
     }
+}
 
-    return false;
+void Game::movePiece(Position from, Position to) {
+    movePiece(from.square(), to.square());
 }
 
-bool Game::isValidMove(const Move move) const {
-    std::map<Move, bool, MoveComparator> cache{};
+void Game::movePiece(Square from, Square to) {
+    auto piece = board[from.index()];
 
-    return isValidMove(move, cache, currentPlayer);
+    setPieceAt(from, NONE);
+    setPieceAt(to, piece);
 }
 
-bool Game::isValidMove(const Move move, std::map<Move, bool, MoveComparator>& cache, const PieceColor currentPlayerColor) const {
-    if (cache.contains(move)) {
-        return cache[move];
-    }
+void Game::clearBoard() {
+    board.fill(NONE);
+    pieceBitboards.fill(EMPTY_BITBOARD);
+    colorBitboards.fill(EMPTY_BITBOARD);
+    occupied = EMPTY_BITBOARD;
 
-    // cache[move] = false;
+    attackMapsValid = false;
+    validityTableValid = false;
+    checkInfoValid = false;
 
-    if (move.isCastling) {
-        if (currentPlayerColor == WHITE) {
-            // short, aka king side castling
-            if (move.piece == WHITE_KING && move.from.row == 1 && move.from.col == 'e' && move.to.row == 1 && move.to.col == 'g') {
-                auto isValid = castlingAvailability.WHITE_KING_SIDE &&
-                    pieceAt(1, 'e') == WHITE_KING &&
-                    pieceAt(1, 'h') == WHITE_ROOK &&
-                    pieceAt(1, 'f') == NONE &&
-                    pieceAt(1, 'g') == NONE &&
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'e' }, cache, currentPlayerColor) && // king is not under check
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'f' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'h' }, cache, currentPlayerColor);
+    positionKey = 0;
+    pawnKey = 0;
 
-                cache[move] = isValid;
+    evaluator.clear();
+    accumulator.computed = { false, false };
+}
 
-                return isValid;
-            }
+Bitboard Game::piecesOf(const PieceColor color) const {
+    return colorBitboards[colorIndex(color)];
+}
 
-            // long, aka queen side castling
-            if (move.piece == WHITE_KING && move.from.row == 1 && move.from.col == 'e' && move.to.row == 1 && move.to.col == 'b') {
-                auto isValid = castlingAvailability.WHITE_QUEEN_SIDE &&
-                    pieceAt(1, 'e') == WHITE_KING &&
-                    pieceAt(1, 'a') == WHITE_ROOK &&
-                    pieceAt(1, 'b') == NONE &&
-                    pieceAt(1, 'c') == NONE &&
-                    pieceAt(1, 'd') == NONE &&
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'e' }, cache, currentPlayerColor) && // king is not under check
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'b' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'c' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 1, .col = 'd' }, cache, currentPlayerColor);
-
-                cache[move] = isValid;
-
-                return isValid;
-            }
-        }
-        else {
-            // long, aka queen side castling
-            if (move.piece == BLACK_KING && move.from.row == 8 && move.from.col == 'e' && move.to.row == 8 && move.to.col == 'g') {
-                auto isValid = castlingAvailability.BLACK_KING_SIDE &&
-                    pieceAt(8, 'e') == BLACK_KING &&
-                    pieceAt(8, 'h') == BLACK_ROOK &&
-                    pieceAt(8, 'f') == NONE &&
-                    pieceAt(8, 'g') == NONE &&
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'e' }, cache, currentPlayerColor) && // king is not under check
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'f' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'g' }, cache, currentPlayerColor);
-
-                cache[move] = isValid;
-
-                return isValid;
-            }
+Bitboard Game::piecesOf(const PieceColor color, const PieceType type) const {
+    return pieceBitboards[colorIndex(color) * 6 + type];
+}
 
-            // short, aka king side castling
-            if (move.piece == BLACK_KING && move.from.row == 8 && move.from.col == 'e' && move.to.row == 8 && move.to.col == 'b') {
-                auto isValid = castlingAvailability.BLACK_QUEEN_SIDE &&
-                    pieceAt(8, 'e') == BLACK_KING &&
-                    pieceAt(8, 'a') == BLACK_ROOK &&
-                    pieceAt(8, 'b') == NONE &&
-                    pieceAt(8, 'c') == NONE &&
-                    pieceAt(8, 'd') == NONE &&
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'e' }, cache, currentPlayerColor) && // king is not under check
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'b' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'c' }, cache, currentPlayerColor) &&
-                    !canOpponentMoveTo(Position{ .row = 8, .col = 'd' }, cache, currentPlayerColor);
-
-                cache[move] = isValid;
-
-                return isValid;
-            }
-        }
-    }
+Bitboard Game::occupancy() const {
+    return occupied;
+}
 
-    if (move.isCapture &&
-        move.piece != WHITE_PAWN &&
-        move.piece != BLACK_PAWN &&
-        !((move.piece == WHITE_KING && pieceAt(move.to) == BLACK_KING) || (move.piece == BLACK_KING && pieceAt(move.to) == WHITE_KING))
-    ) {
-        auto isValid = isValidMove(Move{ .piece = move.piece, .from = move.from, .to = move.to }, cache, currentPlayerColor) && opponentPieceAt(move.to);
+std::uint64_t Game::hash() const {
+    return positionKey;
+}
 
-        cache[move] = isValid;
+std::uint64_t Game::pawnHash() const {
+    return pawnKey;
+}
 
-        return isValid;
-    }
+CastlingAvailability Game::castlingAvailability() const {
+    return CastlingAvailability{
+        .WHITE_KING_SIDE = (castlingRights & WHITE_KING_SIDE_CASTLING) != 0,
+        .WHITE_QUEEN_SIDE = (castlingRights & WHITE_QUEEN_SIDE_CASTLING) != 0,
+        .BLACK_KING_SIDE = (castlingRights & BLACK_KING_SIDE_CASTLING) != 0,
+        .BLACK_QUEEN_SIDE = (castlingRights & BLACK_QUEEN_SIDE_CASTLING) != 0
+    };
+}
 
-    if (move.promotion.has_value()) {
-        if (currentPlayerColor == WHITE) {
-            auto isValid = move.piece == WHITE_PAWN &&
-                move.to.row == 8 &&
-                isValidMove(Move{ .piece = move.piece, .from = move.from, .to = move.to, .isCapture = move.isCapture }, cache, currentPlayerColor) &&
-                (move.promotion == WHITE_QUEEN || move.promotion == WHITE_ROOK || move.promotion == WHITE_BISHOP || move.promotion == WHITE_KNIGHT);
+std::uint64_t Game::computeHash() const {
+    std::uint64_t hash = 0;
 
-            cache[move] = isValid;
+    for (int index = 0; index < 12; ++index) {
+        auto pieces = pieceBitboards[index];
 
-            return isValid;
+        while (pieces) {
+            hash ^= ZOBRIST.pieces[index][popLsb(pieces).index()];
         }
-        else {
-            auto isValid = move.piece == BLACK_PAWN &&
-                move.to.row == 1 &&
-                isValidMove(Move{ .piece = move.piece, .from = move.from, .to = move.to, .isCapture = move.isCapture }, cache, currentPlayerColor) &&
-                (move.promotion == BLACK_QUEEN || move.promotion == BLACK_ROOK || move.promotion == BLACK_BISHOP || move.promotion == BLACK_KNIGHT);
+    }
 
-            cache[move] = isValid;
+    hash ^= ZOBRIST.castling[castlingRights];
 
-            return isValid;
-        }
+    if (enPassantTarget.has_value()) {
+        hash ^= ZOBRIST.enPassant[enPassantTarget->file()];
     }
 
-    // TODO: move this to #applyMove()
-    /*if (currentPlayer == WHITE && move.piece != WHITE_PAWN && move.piece != WHITE_ROOK && move.piece != WHITE_KNIGHT && move.piece != WHITE_BISHOP && move.piece != WHITE_QUEEN && move.piece != WHITE_KING) {
-        return false;
+    if (currentPlayer == BLACK) {
+        hash ^= ZOBRIST.blackToMove;
     }
 
-    if (currentPlayer == BLACK && move.piece != BLACK_PAWN && move.piece != BLACK_ROOK && move.piece != BLACK_KNIGHT && move.piece != BLACK_BISHOP && move.piece != BLACK_QUEEN && move.piece != BLACK_KING) {
-        return false;
-    }*/
-
-    if (move.piece == WHITE_PAWN) {
-        if (move.isCapture) {
-            auto isValid = move.from.row == move.to.row - 1 &&
-                (
-                    (move.from.col > 'a' && move.from.col == move.to.col - 1) ||
-                    (move.from.col < 'h' && move.from.col == move.to.col + 1) ||
-                    (move.from.col == 'a' && move.to.col == 'b') ||
-                    (move.from.col == 'h' && move.to.col == 'g')
-                    ) &&
-                (
-                    opponentPieceAt(move.to) ||
-                    // en passant
-                    (
-                        move.from.row == 5 &&
-                        opponentPieceAt(Position{ .row = move.from.row, .col = move.to.col }) &&
-                        moveHistory.size() > 1 &&
-                        moveHistory.at(moveHistory.size() - 1).piece == BLACK_PAWN &&
-                        moveHistory.at(moveHistory.size() - 1).from.row == 7 &&
-                        moveHistory.at(moveHistory.size() - 1).to.row == 5
-                        )
-                    );
-
-            cache[move] = isValid;
-
-            return isValid;
-        }
-        else {
-            if (move.from.row == 2 && move.to.row == move.from.row + 2) {
-                auto isValid = move.from.col == move.to.col &&
-                    pieceAt(move.to) == NONE &&
-                    pieceAt(Position{ .row = move.from.row + 1, .col = move.from.col }) == NONE;
-
-                cache[move] = isValid;
-
-                return isValid;
-            }
+    return hash;
+}
 
-            auto isValid = move.to.row == move.from.row + 1 &&
-                move.from.col == move.to.col &&
-                pieceAt(move.to) == NONE;
+std::uint64_t Game::computePawnHash() const {
+    std::uint64_t hash = 0;
 
-            cache[move] = isValid;
+    for (auto color : { WHITE, BLACK }) {
+        auto pawns = piecesOf(color, PAWN);
 
-            return isValid;
+        while (pawns) {
+            hash ^= ZOBRIST.pieces[pieceIndex(makePiece(color, PAWN))][popLsb(pawns).index()];
         }
     }
-    else if (move.piece == BLACK_PAWN) {
-        if (move.isCapture) {
-            auto isValid = move.from.row == move.to.row + 1 &&
-                (
-                    (move.from.col > 'a' && move.from.col == move.to.col - 1) ||
-                    (move.from.col < 'h' && move.from.col == move.to.col + 1) ||
-                    (move.from.col == 'a' && move.to.col == 'b') ||
-                    (move.from.col == 'h' && move.to.col == 'g')
-                    ) &&
-                (
-                    opponentPieceAt(move.to) ||
-                    // en passant
-                    (
-                        move.from.row == 4 &&
-                        opponentPieceAt(Position{ .row = move.from.row, .col = move.to.col }) &&
-                        moveHistory.size() > 1 &&
-                        moveHistory.at(moveHistory.size() - 1).piece == WHITE_PAWN &&
-                        moveHistory.at(moveHistory.size() - 1).from.row == 2 &&
-                        moveHistory.at(moveHistory.size() - 1).to.row == 4
-                        )
-                    );
-
-            cache[move] = isValid;
-
-            return isValid;
-        }
-        else {
-            if (move.from.row == 7 && move.to.row == move.from.row - 2) {
-                auto isValid = pieceAt(move.to) == NONE && pieceAt(Position{ .row = move.from.row - 1, .col = move.from.col }) == NONE;
 
-                cache[move] = isValid;
+    return hash;
+}
 
-                return isValid;
-            }
+int Game::evaluate() const {
+    return evaluator.evaluate(currentPlayer);
+}
 
-            auto isValid = move.to.row == move.from.row - 1 &&
-                move.from.col == move.to.col &&
-                pieceAt(move.to) == NONE;
+int Game::computeEvaluation() const {
+    Evaluator fromScratch;
 
-            cache[move] = isValid;
+    for (int index = 0; index < 12; ++index) {
+        auto pieces = pieceBitboards[index];
+        auto piece = makePiece(index < 6 ? WHITE : BLACK, static_cast<PieceType>(index % 6));
 
-            return isValid;
+        while (pieces) {
+            fromScratch.addPiece(piece, popLsb(pieces));
         }
     }
 
-    if (move.piece == WHITE_KING || move.piece == BLACK_KING) {
-        // can not move to the square under attack
-        // compare currentPlayer and currentPlayerColor to prevent going into recursion for two kings
-        if (currentPlayer == currentPlayerColor && canOpponentMoveTo(move.to, cache, currentPlayerColor)) {
-            cache[move] = false;
+    return fromScratch.evaluate(currentPlayer);
+}
 
-            return false;
+void Game::setNetwork(const Network* newNetwork) {
+    network = newNetwork;
+    accumulator.computed = { false, false };
+}
+
+int Game::evaluateNetwork() const {
+    if (!network) {
+        return evaluate();
+    }
+
+    for (auto perspective : { WHITE, BLACK }) {
+        if (!accumulator.computed[colorIndex(perspective)]) {
+            network->refreshAccumulator(accumulator, perspective, pieceBitboards);
         }
+    }
 
-        auto isValid = (
-            (move.from.col < 'h' && move.to.col == move.from.col + 1) ||
-            (move.from.col > 'a' && move.to.col == move.from.col - 1) ||
-            (move.from.col == move.to.col)
-        ) && (
-            (move.from.row > 1 && move.to.row == move.from.row - 1) ||
-            (move.from.row < 8 && move.to.row == move.from.row + 1) ||
-            (move.from.row == move.to.row)
-        ) &&
-            !allyPieceAt(move.to, currentPlayerColor);
+    return network->evaluate(accumulator, currentPlayer);
+}
 
-        cache[move] = isValid;
+bool Game::opponentPieceAt(const Position pos) const {
+    return opponentPieceAt(pos, currentPlayer);
+}
 
-        return isValid;
-    }
+bool Game::opponentPieceAt(const Position pos, const PieceColor currentPlayerColor) const {
+    return (piecesOf(opponentColor(currentPlayerColor)) & squareBit(pos.square())) != 0;
+}
 
-    if (move.piece == WHITE_ROOK || move.piece == BLACK_ROOK) {
-        if (move.from.col != move.to.col && move.from.row != move.to.row) {
-            cache[move] = false;
+bool Game::allyPieceAt(const Position pos) const {
+    return allyPieceAt(pos, currentPlayer);
+}
 
-            return false;
-        }
+bool Game::allyPieceAt(const Position pos, const PieceColor currentPlayerColor) const {
+    return (piecesOf(currentPlayerColor) & squareBit(pos.square())) != 0;
+}
 
-        if (allyPieceAt(move.to, currentPlayerColor)) {
-            cache[move] = false;
+bool Game::canOpponentMoveTo(const Position pos) const {
+    return canOpponentMoveTo(pos, currentPlayer);
+}
 
-            return false;
-        }
+bool Game::canOpponentMoveTo(const Position pos, const PieceColor currentPlayerColor) const {
+    return (attackedSquares(opponentColor(currentPlayerColor)) & squareBit(pos.square())) != 0;
+}
 
-        /*for (auto row = std::min(move.from.row, move.to.row), col = std::min(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col));
-            row <= std::max(move.from.row, move.to.row) || col <= std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col));
-            ++row, ++col
-        ) {
-            if (row == move.from.row && col == move.from.col)
-                continue;
+Bitboard Game::attackedSquares(const PieceColor byColor) const {
+    if (!attackMapsValid) {
+        computeAttackMaps();
+    }
 
-            if (pieceAt(Position{ .row = row, .col = static_cast<char>(col) }) != NONE) {
-                cache[move] = false;
+    return attackMaps[colorIndex(byColor)];
+}
 
-                return false;
-            }
-        }*/
+void Game::computeAttackMaps() const {
+    for (auto color : { WHITE, BLACK }) {
+        // sliders see through the king of the other side, so that the king can not step back along the ray it is attacked on
+        auto occupiedSquares = occupied & ~piecesOf(opponentColor(color), KING);
+        auto attacks = EMPTY_BITBOARD;
 
-        auto it = RookMoveIterator(move.from, move.to);
+        auto pawns = piecesOf(color, PAWN);
 
-        while (it.hasNext()) {
-            if (pieceAt(*it) != NONE) {
-                cache[move] = false;
+        while (pawns) {
+            attacks |= pawnAttacks(color, popLsb(pawns));
+        }
 
-                return false;
-            }
+        auto knights = piecesOf(color, KNIGHT);
 
-            ++it;
+        while (knights) {
+            attacks |= knightAttacks(popLsb(knights));
         }
 
-        cache[move] = (*it == move.to);
+        auto diagonalSliders = piecesOf(color, BISHOP) | piecesOf(color, QUEEN);
 
-        return true;
-    }
+        while (diagonalSliders) {
+            attacks |= bishopAttacks(popLsb(diagonalSliders), occupiedSquares);
+        }
 
-    if (move.piece == WHITE_BISHOP || move.piece == BLACK_BISHOP) {
-        if (move.from.col == move.to.col || move.from.row == move.to.row) {
-            cache[move] = false;
+        auto straightSliders = piecesOf(color, ROOK) | piecesOf(color, QUEEN);
 
-            return false;
+        while (straightSliders) {
+            attacks |= rookAttacks(popLsb(straightSliders), occupiedSquares);
         }
 
-        if (allyPieceAt(move.to, currentPlayerColor)) {
-            cache[move] = false;
+        auto kings = piecesOf(color, KING);
 
-            return false;
+        while (kings) {
+            attacks |= kingAttacks(popLsb(kings));
         }
 
-        /*auto row = std::min(move.from.row, move.to.row);
-        auto col = std::min(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col));
+        attackMaps[colorIndex(color)] = attacks;
+    }
 
-        while (row <= std::max(move.from.row, move.to.row) && col <= std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col))) {
-            if (row != move.from.row && col != move.from.col && pieceAt(Position{ .row = row, .col = static_cast<char>(col) }) != NONE) {
-                cache[move] = false;
+    attackMapsValid = true;
+}
 
-                return false;
-            }
+bool Game::isValidMove(const Move move) const {
+    // the piece has to be able to make the move, and the move must not leave its own king in check
+    return isValidMove(move, currentPlayer) && isLegal(packMove(move));
+}
 
-            if (col < std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col)))
-                ++col;
+MoveValidityTable& Game::validityTableFor(const PieceColor color) const {
+    if (!validityTableValid || validityTableColor != color) {
+        validityTable.clear();
+        validityTableColor = color;
+        validityTableValid = true;
+    }
 
-            if (row < std::max(move.from.row, move.to.row))
-                ++row;
+    return validityTable;
+}
 
-            if (col == std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col)) && row == std::max(move.from.row, move.to.row))
-                break;
-        }*/
+bool Game::isValidMove(const Move move, const PieceColor currentPlayerColor) const {
+    // one routine per side and piece type, so that none of them has to branch on either
+    static constexpr PieceMoveValidator VALIDATORS[2][6] = {
+        {
+            &Game::isValidPieceMove<WHITE, PAWN>,
+            &Game::isValidPieceMove<WHITE, KNIGHT>,
+            &Game::isValidPieceMove<WHITE, BISHOP>,
+            &Game::isValidPieceMove<WHITE, ROOK>,
+            &Game::isValidPieceMove<WHITE, QUEEN>,
+            &Game::isValidPieceMove<WHITE, KING>
+        },
+        {
+            &Game::isValidPieceMove<BLACK, PAWN>,
+            &Game::isValidPieceMove<BLACK, KNIGHT>,
+            &Game::isValidPieceMove<BLACK, BISHOP>,
+            &Game::isValidPieceMove<BLACK, ROOK>,
+            &Game::isValidPieceMove<BLACK, QUEEN>,
+            &Game::isValidPieceMove<BLACK, KING>
+        }
+    };
 
-        auto it = BishopMoveIterator(move.from, move.to);
+    // only the pieces of the side validated for can move
+    if (move.piece == NONE || pieceColor(move.piece) != currentPlayerColor) {
+        return false;
+    }
 
-        while (it.hasNext()) {
-            if (pieceAt(*it) != NONE) {
-                cache[move] = false;
+    auto key = PackedMove::fromMove(move);
+    auto& validity = validityTableFor(currentPlayerColor);
 
-                return false;
-            }
+    // the key does not include the piece, so only the moves of the piece actually standing on the from square are
+    // memoized; nor does it keep everything of the move (e.g. the color of a promoted piece), so neither are moves
+    // which do not come back from it unchanged
+    const bool isMemoized = pieceAt(move.from) == move.piece && key.toMove(move.piece) == move;
 
-            ++it;
+    if (isMemoized) {
+        if (auto known = validity.find(key); known.has_value()) {
+            return *known;
         }
+    }
 
-        cache[move] = (*it == move.to);
+    auto isValid = (this->*VALIDATORS[colorIndex(currentPlayerColor)][pieceType(move.piece)])(move);
 
-        return (*it == move.to);
+    if (isMemoized) {
+        validity.store(key, isValid);
     }
 
-    if (move.piece == WHITE_QUEEN || move.piece == BLACK_QUEEN) {
-        if (allyPieceAt(move.to, currentPlayerColor)) {
-            cache[move] = false;
+    return isValid;
+}
+
+template<PieceColor Color, PieceType Type>
+bool Game::isValidPieceMove(const Move move) const {
+    constexpr auto Them = opponentColor(Color);
+
+    const auto from = move.from.square();
+    const auto to = move.to.square();
+    const auto ourPieces = piecesOf(Color);
+    const auto theirPieces = piecesOf(Them);
 
+    // only the king castles
+    if constexpr (Type != KING) {
+        if (move.isCastling) {
             return false;
         }
+    }
 
-        // auto row = std::min(move.from.row, move.to.row);
-        // auto col = std::min(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col));
+    if constexpr (Type == PAWN) {
+        constexpr int forward = (Color == WHITE) ? 8 : -8;
+        constexpr int startRank = (Color == WHITE) ? 1 : 6;
+        constexpr int promotionRank = (Color == WHITE) ? 7 : 0;
 
-        /*while (row <= std::max(move.from.row, move.to.row) && col <= std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col))) {
-            if (row != move.from.row && col != move.to.col && pieceAt(Position{ .row = row, .col = static_cast<char>(col) }) != NONE) {
-                cache[move] = false;
+        if (move.promotion.has_value()) {
+            auto promotion = *move.promotion;
 
+            if (to.rank() != promotionRank || pieceColor(promotion) != Color || pieceType(promotion) == PAWN || pieceType(promotion) == KING) {
                 return false;
             }
+        }
 
-            if (col >= std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col)) || row >= std::max(move.from.row, move.to.row))
-                break;
-
-            ++col;
-            ++row;
+        if (move.isCapture) {
+            // either a piece on the attacked square or the square just skipped by a two-rank advancement (en passant)
+            return (pawnAttacks(Color, from) & squareBit(to)) != 0 &&
+                ((theirPieces & squareBit(to)) != 0 || enPassantSquare() == to);
+        }
 
-            if (col == std::max(static_cast<unsigned int>(move.from.col), static_cast<unsigned int>(move.to.col)) && row == std::max(move.from.row, move.to.row))
-                break;
-        }*/
+        if (from.rank() == startRank && to.index() == from.index() + 2 * forward) {
+            return !(occupied & (squareBit(to) | squareBit(from + forward)));
+        }
 
-        auto it = QueenMoveIterator(move.from, move.to);
+        return to.index() == from.index() + forward && !(occupied & squareBit(to));
+    }
+    else {
+        if (move.promotion.has_value()) {
+            return false;
+        }
 
-        while (it.hasNext()) {
-            if (pieceAt(*it) != NONE) {
-                cache[move] = false;
+        if constexpr (Type == KING) {
+            constexpr unsigned int row = (Color == WHITE) ? 1 : 8;
+            constexpr Piece rook = makePiece(Color, ROOK);
 
-                return false;
-            }
+            if (move.isCastling && from == makeSquare(row, 'e') && pieceAt(from) == move.piece) {
+                // the king is not in check and does not pass through or land on an attacked square
+                if (to == makeSquare(row, 'g')) {
+                    const bool kingSide = castlingRights & ((Color == WHITE) ? WHITE_KING_SIDE_CASTLING : BLACK_KING_SIDE_CASTLING);
 
-            ++it;
-        }
+                    return kingSide &&
+                        pieceAt(makeSquare(row, 'h')) == rook &&
+                        !(occupied & (squareBit(makeSquare(row, 'f')) | squareBit(makeSquare(row, 'g')))) &&
+                        !(attackedSquares(Them) & (squareBit(makeSquare(row, 'e')) | squareBit(makeSquare(row, 'f')) | squareBit(makeSquare(row, 'g'))));
+                }
 
-        cache[move] = (*it == move.to);
+                if (to == makeSquare(row, 'c')) {
+                    const bool queenSide = castlingRights & ((Color == WHITE) ? WHITE_QUEEN_SIDE_CASTLING : BLACK_QUEEN_SIDE_CASTLING);
 
-        return (*it == move.to);
-    }
+                    return queenSide &&
+                        pieceAt(makeSquare(row, 'a')) == rook &&
+                        !(occupied & (squareBit(makeSquare(row, 'b')) | squareBit(makeSquare(row, 'c')) | squareBit(makeSquare(row, 'd')))) &&
+                        !(attackedSquares(Them) & (squareBit(makeSquare(row, 'e')) | squareBit(makeSquare(row, 'd')) | squareBit(makeSquare(row, 'c'))));
+                }
+            }
 
-    if (move.piece == WHITE_KNIGHT || move.piece == BLACK_KNIGHT) {
-        auto isValid = (
-            // TODO: add validation for boundaries
-            (move.to.row == move.from.row + 2 && move.to.col == move.from.col + 1) ||
-            (move.to.row == move.from.row - 2 && move.to.col == move.from.col + 1) ||
-            (move.to.row == move.from.row + 2 && move.to.col == move.from.col - 1) ||
-            (move.to.row == move.from.row - 2 && move.to.col == move.from.col - 1) ||
+            // castling goes from e to g or c, nowhere else
+            if (move.isCastling) {
+                return false;
+            }
 
-            (move.to.row == move.from.row + 1 && move.to.col == move.from.col + 2) ||
-            (move.to.row == move.from.row - 1 && move.to.col == move.from.col + 2) ||
-            (move.to.row == move.from.row + 1 && move.to.col == move.from.col - 2) ||
-            (move.to.row == move.from.row - 1 && move.to.col == move.from.col - 2)
-        ) && !allyPieceAt(move.to, currentPlayerColor);
+            // can not move to the square under attack
+            if (attackedSquares(Them) & squareBit(to)) {
+                return false;
+            }
+        }
 
-        cache[move] = isValid;
+        // a capture has to land on an opponent piece, any other move on a square not taken by an own piece
+        const auto targets = move.isCapture ? theirPieces : ~ourPieces;
 
-        return isValid;
+        return (pieceAttacks<Type>(from, occupied) & targets & squareBit(to)) != 0;
     }
-
-    cache[move] = false;
-
-    return false;
 }
 
 void Game::applyMove(const Move move) {
@@ -875,86 +757,138 @@ void Game::applyMove(const Move move) {
         return;
     }
 
-    if (move.isCastling) {
-        if (currentPlayer == WHITE) {
-            // long, aka queen side castling
-            if (move.piece == WHITE_KING && move.to.col == 'g') {
-                movePiece(Position{ .row = 1, .col = 'e' }, Position{ .row = 1, .col = 'g' });
-                movePiece(Position{ .row = 1, .col = 'h' }, Position{ .row = 1, .col = 'f' });
+    makeMove(move);
+}
 
-                castlingAvailability.WHITE_KING_SIDE = false;
-                castlingAvailability.WHITE_QUEEN_SIDE = false;
-            }
+void Game::makeMove(const Move move) {
+    makeMove(packMove(move));
+}
 
-            // short, aka king side castling
-            if (move.piece == WHITE_KING && move.to.col == 'b') {
-                movePiece(Position{ .row = 1, .col = 'e' }, Position{ .row = 1, .col = 'b' });
-                movePiece(Position{ .row = 1, .col = 'a' }, Position{ .row = 1, .col = 'c' });
+void Game::makeMove(const PackedMove move) {
+    auto from = move.from();
+    auto to = move.to();
+    auto piece = board[from.index()];
+    auto captured = move.isEnPassant() ? makePiece(opponentColor(currentPlayer), PAWN) : board[to.index()];
 
-                castlingAvailability.WHITE_KING_SIDE = false;
-                castlingAvailability.WHITE_QUEEN_SIDE = false;
-            }
-        }
-        else {
-            // long, aka queen side castling
-            if (move.piece == BLACK_KING && move.to.col == 'g') {
-                movePiece(Position{ .row = 8, .col = 'e' }, Position{ .row = 8, .col = 'g' });
-                movePiece(Position{ .row = 8, .col = 'h' }, Position{ .row = 8, .col = 'f' });
+    undoStack.push_back(UndoState{
+        .positionKey = positionKey,
+        .pawnKey = pawnKey,
+        .halfmoveClock = static_cast<std::uint16_t>(halfmoveClock),
+        .move = move,
+        .captured = captured,
+        .castlingRights = castlingRights,
+        .enPassantTarget = enPassantTarget
+    });
 
-                castlingAvailability.BLACK_KING_SIDE = false;
-                castlingAvailability.BLACK_QUEEN_SIDE = false;
-            }
+    halfmoveClock = (pieceType(piece) == PAWN || move.isCapture()) ? 0 : halfmoveClock + 1;
 
-            // short, aka king side castling
-            if (move.piece == BLACK_KING && move.to.col == 'b') {
-                movePiece(Position{ .row = 8, .col = 'e' }, Position{ .row = 8, .col = 'b' });
-                movePiece(Position{ .row = 8, .col = 'a' }, Position{ .row = 8, .col = 'c' });
+    // the rights and the en passant square of the position left behind are taken out of the key, the new ones put back in the end
+    positionKey ^= ZOBRIST.castling[castlingRights];
 
-                castlingAvailability.BLACK_KING_SIDE = false;
-                castlingAvailability.BLACK_QUEEN_SIDE = false;
-            }
-        }
+    if (enPassantTarget.has_value()) {
+        positionKey ^= ZOBRIST.enPassant[enPassantTarget->file()];
     }
 
-    if (currentPlayer == WHITE && move.piece == WHITE_ROOK && !move.isCastling && move.from.row == 1) {
-        if (move.from.col == 'h') {
-            castlingAvailability.WHITE_KING_SIDE = false;
+    if (move.isCastling()) {
+        auto row = static_cast<unsigned int>(from.rank()) + 1;
+
+        movePiece(from, to);
+
+        if (move.flags() == KING_SIDE_CASTLING) {
+            movePiece(makeSquare(row, 'h'), makeSquare(row, 'f'));
         }
-        else if (move.from.col == 'a') {
-            castlingAvailability.WHITE_QUEEN_SIDE = false;
+        else {
+            movePiece(makeSquare(row, 'a'), makeSquare(row, 'd'));
         }
     }
-    else if (currentPlayer == BLACK && move.piece == BLACK_ROOK && !move.isCastling && move.from.row == 8) {
-        if (move.from.col == 'h') {
-            castlingAvailability.BLACK_KING_SIDE = false;
-        }
-        else if (move.from.col == 'a') {
-            castlingAvailability.BLACK_QUEEN_SIDE = false;
+    else {
+        if (move.isEnPassant()) {
+            setPieceAt(Square::fromFileRank(to.file(), from.rank()), NONE);
         }
+
+        setPieceAt(from, NONE);
+        setPieceAt(to, move.isPromotion() ? makePiece(pieceColor(piece), move.promotionType()) : piece);
+    }
+
+    castlingRights &= CASTLING_RIGHTS_KEPT[from.index()] & CASTLING_RIGHTS_KEPT[to.index()];
+    enPassantTarget = move.isDoublePawnPush() ? std::optional<Square>(Square((from.index() + to.index()) / 2)) : std::nullopt;
+
+    if (currentPlayer == BLACK) {
+        ++fullmoveNumber;
+    }
+
+    currentPlayer = opponentColor(currentPlayer);
+
+    moveHistory.push_back(move);
+
+    positionKey ^= ZOBRIST.castling[castlingRights] ^ ZOBRIST.blackToMove;
+
+    if (enPassantTarget.has_value()) {
+        positionKey ^= ZOBRIST.enPassant[enPassantTarget->file()];
     }
+}
+
+void Game::undoMove() {
+    auto state = undoStack.back();
+    auto move = state.move;
 
-    if (currentPlayer == WHITE && move.piece == WHITE_KING && !move.isCastling) {
-        castlingAvailability.WHITE_KING_SIDE = false;
-        castlingAvailability.WHITE_QUEEN_SIDE = false;
+    undoStack.pop_back();
+
+    // the history may have been trimmed in the meantime
+    if (!moveHistory.empty() && moveHistory.back() == move) {
+        moveHistory.pop_back();
     }
-    else if (currentPlayer == BLACK && move.piece == BLACK_KING && !move.isCastling) {
-        castlingAvailability.BLACK_KING_SIDE = false;
-        castlingAvailability.BLACK_QUEEN_SIDE = false;
+
+    currentPlayer = opponentColor(currentPlayer);
+
+    if (currentPlayer == BLACK) {
+        --fullmoveNumber;
     }
 
-    // TODO: if check conditions fulfill, remove castlingAvailability
+    auto from = move.from();
+    auto to = move.to();
 
-    if (move.promotion.has_value()) {
-        setPieceAt(move.from, NONE);
-        setPieceAt(move.to, move.promotion.value());
+    if (move.isCastling()) {
+        auto row = static_cast<unsigned int>(from.rank()) + 1;
+
+        movePiece(to, from);
+
+        if (move.flags() == KING_SIDE_CASTLING) {
+            movePiece(makeSquare(row, 'f'), makeSquare(row, 'h'));
+        }
+        else {
+            movePiece(makeSquare(row, 'd'), makeSquare(row, 'a'));
+        }
     }
     else {
-        if ((move.isCapture && opponentPieceAt(move.to)) || (!move.isCapture && pieceAt(move.to) == NONE)) {
-            movePiece(move.from, move.to);
+        auto piece = move.isPromotion() ? makePiece(currentPlayer, PAWN) : board[to.index()];
+
+        if (move.isEnPassant()) {
+            setPieceAt(to, NONE);
+            setPieceAt(Square::fromFileRank(to.file(), from.rank()), state.captured);
+        }
+        else {
+            setPieceAt(to, state.captured);
         }
+
+        setPieceAt(from, piece);
     }
 
-    currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+    castlingRights = state.castlingRights;
+    enPassantTarget = state.enPassantTarget;
+    halfmoveClock = state.halfmoveClock;
 
-    moveHistory.push_back(move);
+    positionKey = state.positionKey;
+    pawnKey = state.pawnKey;
+}
+
+PackedMove Game::packMove(const Move move) const {
+    // en passant is the only capture landing on an empty square
+    auto isEnPassant = move.isCapture && pieceType(move.piece) == PAWN && pieceAt(move.to) == NONE;
+
+    return PackedMove::fromMove(move, isEnPassant);
+}
+
+Move Game::unpackMove(const PackedMove move) const {
+    return move.toMove(board[move.from().index()]);
 }
@@ -0,0 +1,424 @@
+#include "chesslib/Game.hpp"
+#include "chesslib/Attacks.hpp"
+
+namespace {
+    constexpr MoveFlag PROMOTION_FLAGS[] = { QUEEN_PROMOTION, ROOK_PROMOTION, BISHOP_PROMOTION, KNIGHT_PROMOTION };
+
+    void pushMove(MoveList& moves, Square from, Square to, bool isCapture) {
+        moves.push(PackedMove(from, to, isCapture ? CAPTURE : QUIET_MOVE));
+    }
+
+    void pushPromotions(MoveList& moves, Square from, Square to, bool isCapture) {
+        for (auto flags : PROMOTION_FLAGS) {
+            moves.push(PackedMove(from, to, static_cast<MoveFlag>(flags | (isCapture ? CAPTURE : 0))));
+        }
+    }
+}
+
+std::optional<Square> Game::enPassantSquare() const {
+    return enPassantTarget;
+}
+
+Bitboard Game::attackersTo(Square square, Bitboard occupiedSquares) const {
+    return (pawnAttacks(BLACK, square) & piecesOf(WHITE, PAWN)) |
+        (pawnAttacks(WHITE, square) & piecesOf(BLACK, PAWN)) |
+        (knightAttacks(square) & (piecesOf(WHITE, KNIGHT) | piecesOf(BLACK, KNIGHT))) |
+        (kingAttacks(square) & (piecesOf(WHITE, KING) | piecesOf(BLACK, KING))) |
+        (bishopAttacks(square, occupiedSquares) & (piecesOf(WHITE, BISHOP) | piecesOf(BLACK, BISHOP) | piecesOf(WHITE, QUEEN) | piecesOf(BLACK, QUEEN))) |
+        (rookAttacks(square, occupiedSquares) & (piecesOf(WHITE, ROOK) | piecesOf(BLACK, ROOK) | piecesOf(WHITE, QUEEN) | piecesOf(BLACK, QUEEN)));
+}
+
+bool Game::isSquareAttacked(Square square, const PieceColor byColor, Bitboard occupiedSquares) const {
+    return (pawnAttacks(opponentColor(byColor), square) & piecesOf(byColor, PAWN)) ||
+        (knightAttacks(square) & piecesOf(byColor, KNIGHT)) ||
+        (kingAttacks(square) & piecesOf(byColor, KING)) ||
+        (bishopAttacks(square, occupiedSquares) & (piecesOf(byColor, BISHOP) | piecesOf(byColor, QUEEN))) ||
+        (rookAttacks(square, occupiedSquares) & (piecesOf(byColor, ROOK) | piecesOf(byColor, QUEEN)));
+}
+
+bool Game::isInCheck() const {
+    return checkers() != EMPTY_BITBOARD;
+}
+
+Bitboard Game::checkers() const {
+    if (!checkInfoValid || checkInfoColor != currentPlayer) {
+        computeCheckInfo();
+    }
+
+    return checkersCache;
+}
+
+Bitboard Game::pinned() const {
+    if (!checkInfoValid || checkInfoColor != currentPlayer) {
+        computeCheckInfo();
+    }
+
+    return pinnedCache;
+}
+
+Bitboard Game::pinRay(Square square) const {
+    auto king = piecesOf(currentPlayer, KING);
+
+    return (king && (pinned() & squareBit(square))) ? line(lsb(king), square) : ALL_SQUARES;
+}
+
+void Game::computeCheckInfo() const {
+    const auto us = currentPlayer;
+    const auto them = opponentColor(us);
+    const auto ourKing = piecesOf(us, KING);
+
+    checkersCache = EMPTY_BITBOARD;
+    pinnedCache = EMPTY_BITBOARD;
+
+    // positions without a king (which some of the setups in tests use) simply have no check constraints
+    if (ourKing) {
+        const auto kingSquare = lsb(ourKing);
+
+        checkersCache = attackersTo(kingSquare, occupied) & piecesOf(them);
+
+        // sliders which would attack the king if there were no pieces in between
+        auto snipers = ((rookAttacks(kingSquare, EMPTY_BITBOARD) & (piecesOf(them, ROOK) | piecesOf(them, QUEEN))) |
+            (bishopAttacks(kingSquare, EMPTY_BITBOARD) & (piecesOf(them, BISHOP) | piecesOf(them, QUEEN))));
+
+        while (snipers) {
+            auto blockers = between(kingSquare, popLsb(snipers)) & occupied;
+
+            if (popCount(blockers) == 1) {
+                pinnedCache |= blockers & piecesOf(us);
+            }
+        }
+    }
+
+    checkInfoColor = us;
+    checkInfoValid = true;
+}
+
+bool Game::isLegal(const PackedMove move) const {
+    const auto us = currentPlayer;
+    const auto them = opponentColor(us);
+    const auto ourKing = piecesOf(us, KING);
+
+    if (!ourKing) {
+        return true;
+    }
+
+    const auto kingSquare = lsb(ourKing);
+    const auto from = move.from();
+    const auto to = move.to();
+
+    if (from == kingSquare) {
+        if (move.isCastling()) {
+            // the king may not castle out of, through or into check
+            auto path = between(from, to) | squareBit(from) | squareBit(to);
+
+            return !(attackedSquares(them) & path);
+        }
+
+        // tested without the king on the board, so it can not step back along a checking ray
+        return !isSquareAttacked(to, them, occupied ^ ourKing);
+    }
+
+    if (move.isEnPassant()) {
+        // two pieces leave the same rank, so the capture is verified on the resulting board
+        auto capturedSquare = Square::fromFileRank(to.file(), from.rank());
+        auto occupiedAfter = (occupied ^ squareBit(from) ^ squareBit(capturedSquare)) | squareBit(to);
+
+        return !(attackersTo(kingSquare, occupiedAfter) & piecesOf(them) & ~squareBit(capturedSquare));
+    }
+
+    const auto checkingPieces = checkers();
+
+    if (checkingPieces) {
+        // only the king moves out of a double check; a single one has to be blocked or the checker captured
+        if (popCount(checkingPieces) > 1 || !((between(kingSquare, lsb(checkingPieces)) | checkingPieces) & squareBit(to))) {
+            return false;
+        }
+    }
+
+    return (pinRay(from) & squareBit(to)) != 0;
+}
+
+bool Game::givesCheck(const PackedMove move) const {
+    const auto us = currentPlayer;
+    const auto them = opponentColor(us);
+    const auto theirKing = piecesOf(them, KING);
+
+    if (!theirKing) {
+        return false;
+    }
+
+    const auto kingSquare = lsb(theirKing);
+    const auto from = move.from();
+    const auto to = move.to();
+    const auto movingType = pieceType(board[from.index()]);
+    const auto arrivingType = move.isPromotion() ? move.promotionType() : movingType;
+
+    // our pieces and the occupancy as they are after the move; the captured piece only matters as a blocker, and its
+    // square is taken by the moving piece anyway (but for en passant)
+    std::array<Bitboard, 6> ours;
+
+    for (int type = PAWN; type <= KING; ++type) {
+        ours[type] = piecesOf(us, static_cast<PieceType>(type));
+    }
+
+    auto occupiedAfter = (occupied ^ squareBit(from)) | squareBit(to);
+
+    ours[movingType] ^= squareBit(from);
+    ours[arrivingType] |= squareBit(to);
+
+    if (move.isEnPassant()) {
+        occupiedAfter ^= squareBit(Square::fromFileRank(to.file(), from.rank()));
+    }
+
+    if (move.isCastling()) {
+        auto rookFrom = Square::fromFileRank(move.flags() == KING_SIDE_CASTLING ? 7 : 0, from.rank());
+        auto rookTo = Square::fromFileRank(move.flags() == KING_SIDE_CASTLING ? 5 : 3, from.rank());
+
+        occupiedAfter = (occupiedAfter ^ squareBit(rookFrom)) | squareBit(rookTo);
+        ours[ROOK] = (ours[ROOK] ^ squareBit(rookFrom)) | squareBit(rookTo);
+    }
+
+    return (pawnAttacks(them, kingSquare) & ours[PAWN]) ||
+        (knightAttacks(kingSquare) & ours[KNIGHT]) ||
+        (bishopAttacks(kingSquare, occupiedAfter) & (ours[BISHOP] | ours[QUEEN])) ||
+        (rookAttacks(kingSquare, occupiedAfter) & (ours[ROOK] | ours[QUEEN]));
+}
+
+void Game::generateLegalMoves(MoveList& moves) const {
+    generateMoves<ALL_MOVES>(moves);
+}
+
+void Game::generateCaptures(MoveList& moves) const {
+    generateMoves<CAPTURE_MOVES>(moves);
+}
+
+void Game::generateQuiets(MoveList& moves) const {
+    generateMoves<QUIET_MOVES>(moves);
+}
+
+void Game::generateEvasions(MoveList& moves) const {
+    generateMoves<EVASION_MOVES>(moves);
+}
+
+template<MoveGenerationType Type>
+void Game::generateMoves(MoveList& moves) const {
+    if (currentPlayer == WHITE) {
+        generateMovesFor<WHITE, Type>(moves);
+    }
+    else {
+        generateMovesFor<BLACK, Type>(moves);
+    }
+}
+
+template<PieceColor Us, MoveGenerationType Type>
+void Game::generateMovesFor(MoveList& moves) const {
+    constexpr auto us = Us;
+    constexpr auto them = opponentColor(Us);
+
+    const auto ourPieces = piecesOf(us);
+    const auto theirPieces = piecesOf(them);
+
+    // positions without a king (which some of the setups in tests use) simply have no check constraints
+    const auto ourKing = piecesOf(us, KING);
+    const bool hasKing = ourKing != EMPTY_BITBOARD;
+    const Square kingSquare = hasKing ? lsb(ourKing) : Square();
+
+    const auto checkingPieces = checkers();
+    const auto pinnedPieces = pinned();
+
+    if constexpr (Type == EVASION_MOVES) {
+        if (!checkingPieces) {
+            return;
+        }
+    }
+
+    // squares the non-king moves may land on
+    Bitboard targets = ALL_SQUARES;
+
+    if constexpr (Type == CAPTURE_MOVES) {
+        targets = theirPieces;
+    }
+    else if constexpr (Type == QUIET_MOVES) {
+        targets = ~occupied;
+    }
+    else {
+        targets = ~ourPieces;
+    }
+
+    auto kingTargets = targets;
+
+    if (checkingPieces) {
+        // blocking the check or capturing the checker; only king moves are left on a double check
+        targets &= (popCount(checkingPieces) > 1) ? EMPTY_BITBOARD : (between(kingSquare, lsb(checkingPieces)) | checkingPieces);
+    }
+
+    auto allowedTargets = [&](Square from) {
+        return (pinnedPieces & squareBit(from)) ? (targets & line(kingSquare, from)) : targets;
+    };
+
+    if (targets) {
+        // pawns
+        constexpr int forward = (us == WHITE) ? 8 : -8;
+        constexpr int startRank = (us == WHITE) ? 1 : 6;
+        constexpr int promotionRank = (us == WHITE) ? 7 : 0;
+
+        auto pawns = piecesOf(us, PAWN);
+
+        while (pawns) {
+            auto from = popLsb(pawns);
+            auto allowed = allowedTargets(from);
+
+            if constexpr (Type != QUIET_MOVES) {
+                auto captures = pawnAttacks(us, from) & theirPieces & allowed;
+
+                while (captures) {
+                    auto to = popLsb(captures);
+
+                    if (to.rank() == promotionRank) {
+                        pushPromotions(moves, from, to, true);
+                    }
+                    else {
+                        pushMove(moves, from, to, true);
+                    }
+                }
+            }
+
+            if constexpr (Type != CAPTURE_MOVES) {
+                auto to = from + forward;
+
+                if (!(occupied & squareBit(to))) {
+                    if (allowed & squareBit(to)) {
+                        if (to.rank() == promotionRank) {
+                            pushPromotions(moves, from, to, false);
+                        }
+                        else {
+                            pushMove(moves, from, to, false);
+                        }
+                    }
+
+                    auto doubleTo = to + forward;
+
+                    if (from.rank() == startRank && !(occupied & squareBit(doubleTo)) && (allowed & squareBit(doubleTo))) {
+                        moves.push(PackedMove(from, doubleTo, DOUBLE_PAWN_PUSH));
+                    }
+                }
+            }
+        }
+
+        if constexpr (Type != QUIET_MOVES) {
+            auto enPassant = enPassantSquare();
+
+            if (enPassant.has_value()) {
+                auto epSquare = *enPassant;
+                auto capturedSquare = epSquare - forward;
+                auto capturers = pawnAttacks(them, epSquare) & piecesOf(us, PAWN);
+
+                while (capturers) {
+                    auto from = popLsb(capturers);
+
+                    // the capture removes two pieces from the same rank, so it is verified on the resulting board
+                    auto occupiedAfter = (occupied ^ squareBit(from) ^ squareBit(capturedSquare)) | squareBit(epSquare);
+
+                    if (hasKing && (attackersTo(kingSquare, occupiedAfter) & theirPieces & ~squareBit(capturedSquare))) {
+                        continue;
+                    }
+
+                    moves.push(PackedMove(from, epSquare, EN_PASSANT_CAPTURE));
+                }
+            }
+        }
+
+        // knights; a pinned knight can never move
+        auto knights = piecesOf(us, KNIGHT) & ~pinnedPieces;
+
+        while (knights) {
+            auto from = popLsb(knights);
+            auto attacks = pieceAttacks<KNIGHT>(from, occupied) & targets;
+
+            while (attacks) {
+                auto to = popLsb(attacks);
+                pushMove(moves, from, to, (theirPieces & squareBit(to)) != 0);
+            }
+        }
+
+        // sliders
+        auto pushSliderMoves = [&]<PieceType SliderType>() {
+            auto sliders = piecesOf(us, SliderType);
+
+            while (sliders) {
+                auto from = popLsb(sliders);
+                auto attacks = pieceAttacks<SliderType>(from, occupied) & allowedTargets(from);
+
+                while (attacks) {
+                    auto to = popLsb(attacks);
+                    pushMove(moves, from, to, (theirPieces & squareBit(to)) != 0);
+                }
+            }
+        };
+
+        pushSliderMoves.template operator()<BISHOP>();
+        pushSliderMoves.template operator()<ROOK>();
+        pushSliderMoves.template operator()<QUEEN>();
+    }
+
+    if (!hasKing) {
+        return;
+    }
+
+    // king; the squares are tested without the king on the board, so it can not step back along a checking ray
+    auto occupiedWithoutKing = occupied ^ ourKing;
+    auto kingMoves = kingAttacks(kingSquare) & kingTargets;
+
+    while (kingMoves) {
+        auto to = popLsb(kingMoves);
+
+        if (!isSquareAttacked(to, them, occupiedWithoutKing)) {
+            pushMove(moves, kingSquare, to, (theirPieces & squareBit(to)) != 0);
+        }
+    }
+
+    if constexpr (Type == ALL_MOVES || Type == QUIET_MOVES) {
+        if (checkingPieces) {
+            return;
+        }
+
+        constexpr unsigned int row = (us == WHITE) ? 1 : 8;
+        const bool kingSide = castlingRights & ((us == WHITE) ? WHITE_KING_SIDE_CASTLING : BLACK_KING_SIDE_CASTLING);
+        const bool queenSide = castlingRights & ((us == WHITE) ? WHITE_QUEEN_SIDE_CASTLING : BLACK_QUEEN_SIDE_CASTLING);
+
+        if (kingSquare != makeSquare(row, 'e')) {
+            return;
+        }
+
+        auto castle = [&](char rookCol, char kingToCol, MoveFlag flags, Bitboard mustBeEmpty, Bitboard mustBeSafe) {
+            if (pieceAt(makeSquare(row, rookCol)) != makePiece(us, ROOK) || (occupied & mustBeEmpty)) {
+                return;
+            }
+
+            while (mustBeSafe) {
+                if (isSquareAttacked(popLsb(mustBeSafe), them, occupied)) {
+                    return;
+                }
+            }
+
+            moves.push(PackedMove(kingSquare, makeSquare(row, kingToCol), flags));
+        };
+
+        if (kingSide) {
+            castle('h', 'g', KING_SIDE_CASTLING,
+                squareBit(makeSquare(row, 'f')) | squareBit(makeSquare(row, 'g')),
+                squareBit(makeSquare(row, 'f')) | squareBit(makeSquare(row, 'g')));
+        }
+
+        if (queenSide) {
+            castle('a', 'c', QUEEN_SIDE_CASTLING,
+                squareBit(makeSquare(row, 'b')) | squareBit(makeSquare(row, 'c')) | squareBit(makeSquare(row, 'd')),
+                squareBit(makeSquare(row, 'c')) | squareBit(makeSquare(row, 'd')));
+        }
+    }
+}
+
+template void Game::generateMoves<ALL_MOVES>(MoveList& moves) const;
+template void Game::generateMoves<CAPTURE_MOVES>(MoveList& moves) const;
+template void Game::generateMoves<QUIET_MOVES>(MoveList& moves) const;
+template void Game::generateMoves<EVASION_MOVES>(MoveList& moves) const;
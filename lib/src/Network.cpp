@@ -0,0 +1,618 @@
+#include "chesslib/Network.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NETWORK_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "network files are read and written in place");
+
+namespace {
+    constexpr std::array<char, 4> NETWORK_MAGIC{ 'C', 'L', 'N', 'N' };
+    constexpr std::uint32_t NETWORK_VERSION = 1;
+
+    constexpr std::size_t INPUT_SIZE = 2 * ACCUMULATOR_SIZE;
+
+    // the SIMD paths take the hidden layers four rows at a time and every input 32 bytes at a time
+    static_assert(HIDDEN_LAYER1_SIZE % 4 == 0 && HIDDEN_LAYER2_SIZE % 4 == 0);
+    static_assert(INPUT_SIZE % 32 == 0 && HIDDEN_LAYER1_SIZE % 32 == 0 && HIDDEN_LAYER2_SIZE % 32 == 0);
+
+    // accumulator += column, wrapping like the SIMD adds do
+    void addColumnScalar(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            values[i] = static_cast<std::int16_t>(values[i] + column[i]);
+        }
+    }
+
+    void subtractColumnScalar(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            values[i] = static_cast<std::int16_t>(values[i] - column[i]);
+        }
+    }
+
+    // one half of the accumulator clipped to 0..127, the input of the first hidden layer
+    void transformScalar(const std::int16_t* values, std::uint8_t* output) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            output[i] = static_cast<std::uint8_t>(std::clamp<int>(values[i], 0, 127));
+        }
+    }
+
+    // output = biases + weights * input, the weights stored row by row
+    void affineScalar(const std::uint8_t* input, std::size_t inputSize, const std::int8_t* weights,
+                      const std::int32_t* biases, std::int32_t* output, std::size_t outputSize) {
+        for (std::size_t row = 0; row < outputSize; ++row) {
+            auto sum = biases[row];
+
+            for (std::size_t i = 0; i < inputSize; ++i) {
+                sum += input[i] * weights[row * inputSize + i];
+            }
+
+            output[row] = sum;
+        }
+    }
+
+    // the output layer, a single row
+    std::int32_t dotScalar(const std::uint8_t* input, const std::int8_t* weights, std::size_t size) {
+        std::int32_t sum = 0;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            sum += input[i] * weights[i];
+        }
+
+        return sum;
+    }
+
+#if defined(NETWORK_X86_SIMD)
+    __attribute__((target("avx2")))
+    void addColumnAvx2(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 16) {
+            auto sum = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), sum);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void subtractColumnAvx2(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 16) {
+            auto difference = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), difference);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void transformAvx2(const std::int16_t* values, std::uint8_t* output) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 32) {
+            // saturating to -128..127, then up to 0; the pack interleaves the 128-bit lanes, the permute sorts them back
+            auto packed = _mm256_packs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 16)));
+
+            packed = _mm256_permute4x64_epi64(_mm256_max_epi8(packed, _mm256_setzero_si256()), 0xD8);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+        }
+    }
+
+    // the inputs are at most 127, so the pairs of products summed by `maddubs` can not saturate; rows go four at a time,
+    // sharing the loads of the input and summed up together at the end
+    __attribute__((target("avx2")))
+    void affineAvx2(const std::uint8_t* input, std::size_t inputSize, const std::int8_t* weights,
+                    const std::int32_t* biases, std::int32_t* output, std::size_t outputSize) {
+        auto ones = _mm256_set1_epi16(1);
+
+        for (std::size_t row = 0; row < outputSize; row += 4) {
+            auto row0 = weights + row * inputSize;
+            auto row1 = row0 + inputSize;
+            auto row2 = row1 + inputSize;
+            auto row3 = row2 + inputSize;
+
+            // four registers rather than an array, which the compiler keeps in memory
+            auto sum0 = _mm256_setzero_si256();
+            auto sum1 = _mm256_setzero_si256();
+            auto sum2 = _mm256_setzero_si256();
+            auto sum3 = _mm256_setzero_si256();
+
+            for (std::size_t i = 0; i < inputSize; i += 32) {
+                auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+
+                sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + i))), ones));
+                sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + i))), ones));
+                sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row2 + i))), ones));
+                sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row3 + i))), ones));
+            }
+
+            // each 128-bit lane ends up with its part of the four rows, in order
+            auto lanes = _mm256_hadd_epi32(_mm256_hadd_epi32(sum0, sum1), _mm256_hadd_epi32(sum2, sum3));
+            auto total = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+
+            total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(biases + row)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + row), total);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    std::int32_t dotAvx2(const std::uint8_t* input, const std::int8_t* weights, std::size_t size) {
+        auto ones = _mm256_set1_epi16(1);
+        auto sum = _mm256_setzero_si256();
+
+        for (std::size_t i = 0; i < size; i += 32) {
+            auto products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)),
+                                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+
+        auto half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+
+        return _mm_cvtsi128_si32(half);
+    }
+
+    __attribute__((target("sse4.1")))
+    void addColumnSse41(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 8) {
+            auto sum = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), sum);
+        }
+    }
+
+    __attribute__((target("sse4.1")))
+    void subtractColumnSse41(std::int16_t* values, const std::int16_t* column) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 8) {
+            auto difference = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), difference);
+        }
+    }
+
+    __attribute__((target("sse4.1")))
+    void transformSse41(const std::int16_t* values, std::uint8_t* output) {
+        for (std::size_t i = 0; i < ACCUMULATOR_SIZE; i += 16) {
+            auto packed = _mm_packs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 8)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_max_epi8(packed, _mm_setzero_si128()));
+        }
+    }
+
+    __attribute__((target("sse4.1")))
+    void affineSse41(const std::uint8_t* input, std::size_t inputSize, const std::int8_t* weights,
+                     const std::int32_t* biases, std::int32_t* output, std::size_t outputSize) {
+        auto ones = _mm_set1_epi16(1);
+
+        for (std::size_t row = 0; row < outputSize; row += 4) {
+            auto row0 = weights + row * inputSize;
+            auto row1 = row0 + inputSize;
+            auto row2 = row1 + inputSize;
+            auto row3 = row2 + inputSize;
+
+            auto sum0 = _mm_setzero_si128();
+            auto sum1 = _mm_setzero_si128();
+            auto sum2 = _mm_setzero_si128();
+            auto sum3 = _mm_setzero_si128();
+
+            for (std::size_t i = 0; i < inputSize; i += 16) {
+                auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+                sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i))), ones));
+                sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i))), ones));
+                sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row2 + i))), ones));
+                sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row3 + i))), ones));
+            }
+
+            auto total = _mm_hadd_epi32(_mm_hadd_epi32(sum0, sum1), _mm_hadd_epi32(sum2, sum3));
+
+            total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(biases + row)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + row), total);
+        }
+    }
+
+    __attribute__((target("sse4.1")))
+    std::int32_t dotSse41(const std::uint8_t* input, const std::int8_t* weights, std::size_t size) {
+        auto ones = _mm_set1_epi16(1);
+        auto sum = _mm_setzero_si128();
+
+        for (std::size_t i = 0; i < size; i += 16) {
+            auto products = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+        }
+
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    bool isSupported(SimdLevel level) {
+        return level <= detectSimdLevel();
+    }
+
+    // output of a hidden layer scaled back and clipped to 0..127, the input of the next one
+    template<std::size_t Size>
+    void clip(const std::array<std::int32_t, Size>& sums, std::array<std::uint8_t, Size>& output) {
+        for (std::size_t i = 0; i < Size; ++i) {
+            output[i] = static_cast<std::uint8_t>(std::clamp(sums[i] >> WEIGHT_SHIFT, 0, 127));
+        }
+    }
+
+    // writes the data of the network front to back into a buffer sized for all of it up front
+    class NetworkWriter {
+    public:
+        explicit NetworkWriter(std::span<char> data) :
+            data(data),
+            offset(0)
+        {
+        }
+
+        template<typename T>
+        void write(const T* values, std::size_t count) {
+            std::memcpy(data.data() + offset, values, count * sizeof(T));
+            offset += count * sizeof(T);
+        }
+
+    private:
+        std::span<char> data;
+        std::size_t offset;
+    };
+
+    // reads the data of the network front to back
+    class NetworkReader {
+    public:
+        explicit NetworkReader(std::span<const char> data) :
+            data(data),
+            offset(0)
+        {
+        }
+
+        template<typename T>
+        bool read(T* values, std::size_t count) {
+            if (data.size() - offset < count * sizeof(T)) {
+                return false;
+            }
+
+            std::memcpy(values, data.data() + offset, count * sizeof(T));
+            offset += count * sizeof(T);
+
+            return true;
+        }
+
+        bool atEnd() const {
+            return offset == data.size();
+        }
+
+    private:
+        std::span<const char> data;
+        std::size_t offset;
+    };
+}
+
+std::string_view networkErrorMessage(NetworkError error) {
+    switch (error) {
+    case NETWORK_FILE_UNREADABLE:
+        return "network file unreadable";
+
+    case INVALID_NETWORK_HEADER:
+        return "invalid network header";
+
+    case TRUNCATED_NETWORK:
+        return "truncated network";
+
+    case TRAILING_NETWORK_DATA:
+        return "trailing network data";
+    }
+
+    return "unknown error";
+}
+
+SimdLevel detectSimdLevel() {
+#if defined(NETWORK_X86_SIMD)
+    static const SimdLevel detected = __builtin_cpu_supports("avx2") ? AVX2_SIMD
+                                    : __builtin_cpu_supports("sse4.1") ? SSE41_SIMD
+                                    : NO_SIMD;
+
+    return detected;
+#else
+    return NO_SIMD;
+#endif
+}
+
+Network::Network() :
+    transformerBiases(ACCUMULATOR_SIZE),
+    transformerWeights(HALFKP_FEATURES * ACCUMULATOR_SIZE),
+    hidden1Biases(HIDDEN_LAYER1_SIZE),
+    hidden1Weights(HIDDEN_LAYER1_SIZE * INPUT_SIZE),
+    hidden2Biases(HIDDEN_LAYER2_SIZE),
+    hidden2Weights(HIDDEN_LAYER2_SIZE * HIDDEN_LAYER1_SIZE),
+    outputBias(0),
+    outputWeights(HIDDEN_LAYER2_SIZE),
+    level(detectSimdLevel())
+{
+}
+
+std::expected<std::unique_ptr<Network>, NetworkError> Network::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return std::unexpected(NETWORK_FILE_UNREADABLE);
+    }
+
+    std::vector<char> data(std::istreambuf_iterator<char>(file), {});
+
+    if (file.bad()) {
+        return std::unexpected(NETWORK_FILE_UNREADABLE);
+    }
+
+    return parse(data);
+}
+
+std::expected<std::unique_ptr<Network>, NetworkError> Network::parse(std::span<const char> data) {
+    NetworkReader reader(data);
+
+    std::array<char, 4> magic;
+    std::array<std::uint32_t, 5> header;
+
+    if (!reader.read(magic.data(), magic.size()) || !reader.read(header.data(), header.size())) {
+        return std::unexpected(INVALID_NETWORK_HEADER);
+    }
+
+    // the sizes of the layers are fixed at compile time, a network of any other shape is refused
+    if (magic != NETWORK_MAGIC || header != std::array<std::uint32_t, 5>{ NETWORK_VERSION, HALFKP_FEATURES, ACCUMULATOR_SIZE,
+                                                                          HIDDEN_LAYER1_SIZE, HIDDEN_LAYER2_SIZE }) {
+        return std::unexpected(INVALID_NETWORK_HEADER);
+    }
+
+    std::unique_ptr<Network> network(new Network());
+
+    auto complete = reader.read(network->transformerBiases.data(), network->transformerBiases.size())
+        && reader.read(network->transformerWeights.data(), network->transformerWeights.size())
+        && reader.read(network->hidden1Biases.data(), network->hidden1Biases.size())
+        && reader.read(network->hidden1Weights.data(), network->hidden1Weights.size())
+        && reader.read(network->hidden2Biases.data(), network->hidden2Biases.size())
+        && reader.read(network->hidden2Weights.data(), network->hidden2Weights.size())
+        && reader.read(&network->outputBias, 1)
+        && reader.read(network->outputWeights.data(), network->outputWeights.size());
+
+    if (!complete) {
+        return std::unexpected(TRUNCATED_NETWORK);
+    }
+
+    if (!reader.atEnd()) {
+        return std::unexpected(TRAILING_NETWORK_DATA);
+    }
+
+    return network;
+}
+
+std::unique_ptr<Network> Network::random(std::uint64_t seed) {
+    std::unique_ptr<Network> network(new Network());
+
+    // splitmix64
+    auto next = [state = seed]() mutable {
+        auto z = (state += 0x9E3779B97F4A7C15ULL);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+        return z ^ (z >> 31);
+    };
+
+    auto uniform = [&next](int low, int high) {
+        return low + static_cast<int>(next() % static_cast<std::uint64_t>(high - low + 1));
+    };
+
+    // small enough for the accumulator not to wrap and for the output to stay well under the mate scores
+    for (auto& bias : network->transformerBiases) {
+        bias = static_cast<std::int16_t>(uniform(0, 64));
+    }
+
+    for (auto& weight : network->transformerWeights) {
+        weight = static_cast<std::int16_t>(uniform(-16, 16));
+    }
+
+    for (auto& bias : network->hidden1Biases) {
+        bias = uniform(-4096, 4096);
+    }
+
+    for (auto& weight : network->hidden1Weights) {
+        weight = static_cast<std::int8_t>(uniform(-32, 32));
+    }
+
+    for (auto& bias : network->hidden2Biases) {
+        bias = uniform(-4096, 4096);
+    }
+
+    for (auto& weight : network->hidden2Weights) {
+        weight = static_cast<std::int8_t>(uniform(-64, 64));
+    }
+
+    network->outputBias = uniform(-256, 256);
+
+    for (auto& weight : network->outputWeights) {
+        weight = static_cast<std::int8_t>(uniform(-16, 16));
+    }
+
+    return network;
+}
+
+std::vector<char> Network::serialize() const {
+    std::array<std::uint32_t, 5> header{ NETWORK_VERSION, HALFKP_FEATURES, ACCUMULATOR_SIZE, HIDDEN_LAYER1_SIZE, HIDDEN_LAYER2_SIZE };
+
+    std::vector<char> data(sizeof(NETWORK_MAGIC) + sizeof(header)
+                           + transformerBiases.size() * sizeof(std::int16_t) + transformerWeights.size() * sizeof(std::int16_t)
+                           + hidden1Biases.size() * sizeof(std::int32_t) + hidden1Weights.size()
+                           + hidden2Biases.size() * sizeof(std::int32_t) + hidden2Weights.size()
+                           + sizeof(outputBias) + outputWeights.size());
+    NetworkWriter writer(data);
+
+    writer.write(NETWORK_MAGIC.data(), NETWORK_MAGIC.size());
+    writer.write(header.data(), header.size());
+
+    writer.write(transformerBiases.data(), transformerBiases.size());
+    writer.write(transformerWeights.data(), transformerWeights.size());
+    writer.write(hidden1Biases.data(), hidden1Biases.size());
+    writer.write(hidden1Weights.data(), hidden1Weights.size());
+    writer.write(hidden2Biases.data(), hidden2Biases.size());
+    writer.write(hidden2Weights.data(), hidden2Weights.size());
+    writer.write(&outputBias, 1);
+    writer.write(outputWeights.data(), outputWeights.size());
+
+    return data;
+}
+
+bool Network::save(const std::string& path) const {
+    auto data = serialize();
+    std::ofstream file(path, std::ios::binary);
+
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    return static_cast<bool>(file);
+}
+
+void Network::addFeature(Accumulator& accumulator, PieceColor perspective, std::size_t feature) const {
+    auto values = accumulator.values[colorIndex(perspective)].data();
+    auto column = transformerWeights.data() + feature * ACCUMULATOR_SIZE;
+
+    switch (level) {
+#if defined(NETWORK_X86_SIMD)
+    case AVX2_SIMD:
+        addColumnAvx2(values, column);
+        break;
+
+    case SSE41_SIMD:
+        addColumnSse41(values, column);
+        break;
+#endif
+
+    default:
+        addColumnScalar(values, column);
+        break;
+    }
+}
+
+void Network::removeFeature(Accumulator& accumulator, PieceColor perspective, std::size_t feature) const {
+    auto values = accumulator.values[colorIndex(perspective)].data();
+    auto column = transformerWeights.data() + feature * ACCUMULATOR_SIZE;
+
+    switch (level) {
+#if defined(NETWORK_X86_SIMD)
+    case AVX2_SIMD:
+        subtractColumnAvx2(values, column);
+        break;
+
+    case SSE41_SIMD:
+        subtractColumnSse41(values, column);
+        break;
+#endif
+
+    default:
+        subtractColumnScalar(values, column);
+        break;
+    }
+}
+
+void Network::refreshAccumulator(Accumulator& accumulator, PieceColor perspective, const std::array<Bitboard, 12>& pieceBitboards) const {
+    auto side = colorIndex(perspective);
+    auto kings = pieceBitboards[side * 6 + KING];
+
+    std::copy(transformerBiases.begin(), transformerBiases.end(), accumulator.values[side].begin());
+    accumulator.computed[side] = true;
+
+    // without a king there is nothing to place the pieces against; only happens to boards being set up
+    if (!kings) {
+        return;
+    }
+
+    auto kingSquare = lsb(kings);
+
+    for (int index = 0; index < 12; ++index) {
+        if (index % 6 == KING) {
+            continue;
+        }
+
+        auto pieces = pieceBitboards[index];
+        auto piece = makePiece(index < 6 ? WHITE : BLACK, static_cast<PieceType>(index % 6));
+
+        while (pieces) {
+            addFeature(accumulator, perspective, featureIndex(perspective, kingSquare, piece, popLsb(pieces)));
+        }
+    }
+}
+
+int Network::evaluate(const Accumulator& accumulator, PieceColor sideToMove) const {
+    alignas(64) std::array<std::uint8_t, INPUT_SIZE> input;
+    alignas(64) std::array<std::int32_t, HIDDEN_LAYER1_SIZE> sums1;
+    alignas(64) std::array<std::uint8_t, HIDDEN_LAYER1_SIZE> hidden1;
+    alignas(64) std::array<std::int32_t, HIDDEN_LAYER2_SIZE> sums2;
+    alignas(64) std::array<std::uint8_t, HIDDEN_LAYER2_SIZE> hidden2;
+    std::int32_t output;
+
+    const auto& us = accumulator.values[colorIndex(sideToMove)];
+    const auto& them = accumulator.values[colorIndex(opponentColor(sideToMove))];
+
+    switch (level) {
+#if defined(NETWORK_X86_SIMD)
+    case AVX2_SIMD:
+        transformAvx2(us.data(), input.data());
+        transformAvx2(them.data(), input.data() + ACCUMULATOR_SIZE);
+        affineAvx2(input.data(), INPUT_SIZE, hidden1Weights.data(), hidden1Biases.data(), sums1.data(), HIDDEN_LAYER1_SIZE);
+        clip(sums1, hidden1);
+        affineAvx2(hidden1.data(), HIDDEN_LAYER1_SIZE, hidden2Weights.data(), hidden2Biases.data(), sums2.data(), HIDDEN_LAYER2_SIZE);
+        clip(sums2, hidden2);
+        output = outputBias + dotAvx2(hidden2.data(), outputWeights.data(), HIDDEN_LAYER2_SIZE);
+        break;
+
+    case SSE41_SIMD:
+        transformSse41(us.data(), input.data());
+        transformSse41(them.data(), input.data() + ACCUMULATOR_SIZE);
+        affineSse41(input.data(), INPUT_SIZE, hidden1Weights.data(), hidden1Biases.data(), sums1.data(), HIDDEN_LAYER1_SIZE);
+        clip(sums1, hidden1);
+        affineSse41(hidden1.data(), HIDDEN_LAYER1_SIZE, hidden2Weights.data(), hidden2Biases.data(), sums2.data(), HIDDEN_LAYER2_SIZE);
+        clip(sums2, hidden2);
+        output = outputBias + dotSse41(hidden2.data(), outputWeights.data(), HIDDEN_LAYER2_SIZE);
+        break;
+#endif
+
+    default:
+        transformScalar(us.data(), input.data());
+        transformScalar(them.data(), input.data() + ACCUMULATOR_SIZE);
+        affineScalar(input.data(), INPUT_SIZE, hidden1Weights.data(), hidden1Biases.data(), sums1.data(), HIDDEN_LAYER1_SIZE);
+        clip(sums1, hidden1);
+        affineScalar(hidden1.data(), HIDDEN_LAYER1_SIZE, hidden2Weights.data(), hidden2Biases.data(), sums2.data(), HIDDEN_LAYER2_SIZE);
+        clip(sums2, hidden2);
+        output = outputBias + dotScalar(hidden2.data(), outputWeights.data(), HIDDEN_LAYER2_SIZE);
+        break;
+    }
+
+    return output / OUTPUT_SCALE;
+}
+
+SimdLevel Network::simdLevel() const {
+    return level;
+}
+
+bool Network::setSimdLevel(SimdLevel newLevel) {
+    if (!isSupported(newLevel)) {
+        return false;
+    }
+
+    level = newLevel;
+
+    return true;
+}
@@ -0,0 +1,201 @@
+#include <cstring>
+#include <string_view>
+
+#include "chesslib/Game.hpp"
+
+namespace {
+    constexpr char SAN_PIECE_SYMBOLS[] = { 'P', 'N', 'B', 'R', 'Q', 'K' };
+    constexpr char UCI_PROMOTION_SYMBOLS[] = { 'p', 'n', 'b', 'r', 'q', 'k' };
+
+    char* writeSquare(Square square, char* out) {
+        *out++ = square.fileSymbol();
+        *out++ = square.rankSymbol();
+
+        return out;
+    }
+
+    std::size_t writeUCI(const PackedMove move, char* out) {
+        auto begin = out;
+
+        out = writeSquare(move.from(), out);
+        out = writeSquare(move.to(), out);
+
+        if (move.isPromotion()) {
+            *out++ = UCI_PROMOTION_SYMBOLS[move.promotionType()];
+        }
+
+        return static_cast<std::size_t>(out - begin);
+    }
+
+    // copies the move from the scratch buffer unless it does not fit; returns the number of bytes copied
+    std::size_t copyMove(const char* move, std::size_t length, std::span<char> buffer) {
+        if (length > buffer.size()) {
+            return 0;
+        }
+
+        std::memcpy(buffer.data(), move, length);
+
+        return length;
+    }
+
+    // the position after a checking move is played out on this game, one per thread and reused, so that once its
+    // stacks have grown, telling a check from a mate no longer allocates
+    Game& scratchGame() {
+        thread_local Game scratch;
+
+        return scratch;
+    }
+}
+
+std::size_t Game::writeSAN(const PackedMove move, const MoveList& legalMoves, char* out) const {
+    auto begin = out;
+
+    if (move.isCastling()) {
+        const std::string_view castling = (move.flags() == KING_SIDE_CASTLING) ? "O-O" : "O-O-O";
+
+        std::memcpy(out, castling.data(), castling.size());
+
+        return castling.size();
+    }
+
+    const auto from = move.from();
+    const auto to = move.to();
+    const auto type = pieceType(board[from.index()]);
+
+    if (type == PAWN) {
+        // a capturing pawn is always noted by its file, which is all the disambiguation pawns ever need
+        if (move.isCapture()) {
+            *out++ = from.fileSymbol();
+        }
+    }
+    else {
+        *out++ = SAN_PIECE_SYMBOLS[type];
+
+        // the least of the from square which tells the move apart from the other pieces of the type reaching the square
+        bool isAmbiguous = false;
+        bool sharesFile = false;
+        bool sharesRank = false;
+
+        for (auto other : legalMoves) {
+            if (other.to() != to || other.from() == from || pieceType(board[other.from().index()]) != type) {
+                continue;
+            }
+
+            isAmbiguous = true;
+            sharesFile |= other.from().file() == from.file();
+            sharesRank |= other.from().rank() == from.rank();
+        }
+
+        if (isAmbiguous) {
+            if (!sharesFile) {
+                *out++ = from.fileSymbol();
+            }
+            else if (!sharesRank) {
+                *out++ = from.rankSymbol();
+            }
+            else {
+                out = writeSquare(from, out);
+            }
+        }
+    }
+
+    if (move.isCapture()) {
+        *out++ = 'x';
+    }
+
+    out = writeSquare(to, out);
+
+    if (move.isPromotion()) {
+        *out++ = '=';
+        *out++ = SAN_PIECE_SYMBOLS[move.promotionType()];
+    }
+
+    return static_cast<std::size_t>(out - begin);
+}
+
+std::string Game::serializeMove(const Move move) const {
+    char buffer[MAX_MOVE_LENGTH];
+
+    return std::string(buffer, serializeMove(packMove(move), buffer, SAN_NOTATION));
+}
+
+std::size_t Game::serializeMove(const PackedMove move, std::span<char> buffer, MoveNotation notation) const {
+    MoveList legalMoves;
+    generateLegalMoves(legalMoves);
+
+    if (!legalMoves.contains(move)) {
+        return 0;
+    }
+
+    char scratch[MAX_MOVE_LENGTH];
+
+    if (notation == UCI_NOTATION) {
+        return copyMove(scratch, writeUCI(move, scratch), buffer);
+    }
+
+    auto length = writeSAN(move, legalMoves, scratch);
+
+    // checks are rare, so the position after the move is only played out to tell a check from a mate; loading the
+    // bare position copies none of the history or caches of this game
+    if (givesCheck(move)) {
+        auto& next = scratchGame();
+
+        next.loadPosition(packPosition());
+        next.makeMove(move);
+
+        MoveList evasions;
+        next.generateEvasions(evasions);
+
+        scratch[length++] = evasions.empty() ? '#' : '+';
+    }
+
+    return copyMove(scratch, length, buffer);
+}
+
+MovesSerializeResult Game::serializeMoves(std::span<const Move> moves, std::span<char> buffer, MoveNotation notation) const {
+    MovesSerializeResult result{ .moves = 0, .written = 0 };
+
+    Game replay = *this;
+
+    MoveList legalMoves;
+    replay.generateLegalMoves(legalMoves);
+
+    for (const auto& move : moves) {
+        auto packed = replay.packMove(move);
+
+        if (!legalMoves.contains(packed)) {
+            break;
+        }
+
+        // a separator and the longest move
+        char scratch[MAX_MOVE_LENGTH + 1];
+        std::size_t length = 0;
+
+        if (result.moves > 0) {
+            scratch[length++] = ' ';
+        }
+
+        length += (notation == UCI_NOTATION) ? writeUCI(packed, scratch + length) : replay.writeSAN(packed, legalMoves, scratch + length);
+
+        replay.makeMove(packed);
+
+        // the moves of the new position serve both the mark of this move and the disambiguation of the next one
+        legalMoves.clear();
+        replay.generateLegalMoves(legalMoves);
+
+        if (notation == SAN_NOTATION && replay.isInCheck()) {
+            scratch[length++] = legalMoves.empty() ? '#' : '+';
+        }
+
+        auto copied = copyMove(scratch, length, buffer.subspan(result.written));
+
+        if (copied == 0) {
+            break;
+        }
+
+        result.written += copied;
+        ++result.moves;
+    }
+
+    return result;
+}
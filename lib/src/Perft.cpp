@@ -0,0 +1,225 @@
+#include "chesslib/Perft.hpp"
+
+#include <bit>
+
+namespace {
+    // one per root move; padded so that threads finishing subtrees of neighbouring moves do not share a cache line
+    struct alignas(64) PerftCounter {
+        std::atomic<std::uint64_t> nodes{ 0 };
+    };
+
+    struct PerftStatistics {
+        std::uint64_t probes = 0;
+        std::uint64_t hits = 0;
+    };
+
+    // counts on a single game, making and taking back the moves in place
+    std::uint64_t countLeaves(Game& game, int depth) {
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        // leaf nodes are counted without being made
+        if (depth == 1) {
+            return moves.size();
+        }
+
+        std::uint64_t nodes = 0;
+
+        for (auto move : moves) {
+            game.makeMove(move);
+            nodes += countLeaves(game, depth - 1);
+            game.undoMove();
+        }
+
+        return nodes;
+    }
+
+    std::uint64_t hashedPerft(Game& game, int depth, PerftTable& table, PerftStatistics& statistics) {
+        if (depth <= 0) {
+            return 1;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        // leaf nodes are counted without being made, which is cheaper than a table lookup
+        if (depth == 1) {
+            return moves.size();
+        }
+
+        auto key = game.hash();
+        std::uint64_t nodes = 0;
+
+        ++statistics.probes;
+
+        if (table.probe(key, depth, nodes)) {
+            ++statistics.hits;
+            return nodes;
+        }
+
+        for (auto move : moves) {
+            game.makeMove(move);
+            nodes += hashedPerft(game, depth - 1, table, statistics);
+            game.undoMove();
+        }
+
+        table.store(key, depth, nodes);
+
+        return nodes;
+    }
+
+    std::uint64_t countNodes(const Game& game, int depth, PerftTable* table) {
+        if (!table) {
+            return perft(game, depth);
+        }
+
+        return perft(game, depth, *table);
+    }
+
+    void countSubtree(ThreadPool& pool, const Game& game, int depth, int splitDepth, PerftTable* table, PerftCounter& counter) {
+        if (splitDepth <= 0 || depth <= 1) {
+            counter.nodes += countNodes(game, depth, table);
+            return;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        for (const auto& move : moves) {
+            Game next = game;
+            next.makeMove(move);
+
+            pool.submit([&pool, next = std::move(next), depth, splitDepth, table, &counter]() {
+                countSubtree(pool, next, depth - 1, splitDepth - 1, table, counter);
+            });
+        }
+    }
+}
+
+PerftTable::PerftTable(std::size_t megabytes) :
+    probeCount(0),
+    hitCount(0)
+{
+    // round down to a power of two, so that an entry is picked by masking the key
+    auto count = std::bit_floor(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Entry), 1));
+
+    entries = std::make_unique<Entry[]>(count);
+    mask = count - 1;
+
+    clear();
+}
+
+bool PerftTable::probe(std::uint64_t key, int depth, std::uint64_t& nodes) const {
+    const auto& entry = entries[key & mask];
+
+    auto data = entry.data.load(std::memory_order_relaxed);
+    auto check = entry.check.load(std::memory_order_relaxed);
+
+    // data packs the node count above the depth byte
+    if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth) {
+        return false;
+    }
+
+    nodes = data >> 8;
+
+    return true;
+}
+
+void PerftTable::store(std::uint64_t key, int depth, std::uint64_t nodes) {
+    auto& entry = entries[key & mask];
+
+    auto data = (nodes << 8) | static_cast<std::uint64_t>(depth & 0xFF);
+
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+void PerftTable::clear() {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        entries[i].check.store(0, std::memory_order_relaxed);
+        entries[i].data.store(0, std::memory_order_relaxed);
+    }
+
+    probeCount = 0;
+    hitCount = 0;
+}
+
+std::size_t PerftTable::size() const {
+    return mask + 1;
+}
+
+void PerftTable::addStatistics(std::uint64_t probes, std::uint64_t hits) {
+    probeCount.fetch_add(probes, std::memory_order_relaxed);
+    hitCount.fetch_add(hits, std::memory_order_relaxed);
+}
+
+std::uint64_t PerftTable::probes() const {
+    return probeCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t PerftTable::hits() const {
+    return hitCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t perft(const Game& game, int depth) {
+    if (depth <= 0) {
+        return 1;
+    }
+
+    Game copy = game;
+
+    return countLeaves(copy, depth);
+}
+
+std::uint64_t perft(const Game& game, int depth, PerftTable& table) {
+    PerftStatistics statistics;
+    Game copy = game;
+
+    auto nodes = hashedPerft(copy, depth, table, statistics);
+
+    table.addStatistics(statistics.probes, statistics.hits);
+
+    return nodes;
+}
+
+std::vector<PerftDivide> perftDivide(const Game& game, int depth, PerftTable* table) {
+    MoveList moves;
+    game.generateLegalMoves(moves);
+
+    std::vector<PerftDivide> result;
+
+    for (const auto& move : moves) {
+        Game next = game;
+        next.makeMove(move);
+
+        result.push_back(PerftDivide{ .move = move, .nodes = countNodes(next, depth - 1, table) });
+    }
+
+    return result;
+}
+
+std::vector<PerftDivide> perftDivide(const Game& game, int depth, ThreadPool& pool, int splitDepth, PerftTable* table) {
+    MoveList moves;
+    game.generateLegalMoves(moves);
+
+    auto counters = std::make_unique<PerftCounter[]>(moves.size());
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        Game next = game;
+        next.makeMove(moves[i]);
+
+        pool.submit([&pool, next = std::move(next), depth, splitDepth, table, &counter = counters[i]]() {
+            countSubtree(pool, next, depth - 1, splitDepth - 1, table, counter);
+        });
+    }
+
+    pool.wait();
+
+    std::vector<PerftDivide> result;
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        result.push_back(PerftDivide{ .move = moves[i], .nodes = counters[i].nodes.load() });
+    }
+
+    return result;
+}
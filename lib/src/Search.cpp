@@ -0,0 +1,571 @@
+#include "chesslib/Search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+    // rough centipawn values to order captures and promotions by, indexed by `PieceType`; the king is never captured
+    constexpr std::array<int, 6> PIECE_VALUES{ 100, 320, 330, 500, 900, 0 };
+
+    // the limits are checked against the clock once per this many nodes
+    constexpr std::uint64_t TIME_CHECK_INTERVAL = 2048;
+
+    constexpr int TABLE_MOVE_SCORE = 3'000'000;
+    constexpr int PV_MOVE_SCORE = 2'000'000;
+    constexpr int CAPTURE_SCORE = 1'000'000;
+    constexpr int FIRST_KILLER_SCORE = 900'000;
+    constexpr int SECOND_KILLER_SCORE = 800'000;
+
+    // history scores are halved once they get past this, so they never catch up with the killers
+    constexpr int HISTORY_LIMIT = 400'000;
+
+    // helpers skip the iterations where `(depth + phase) / size` is odd, so that at any time the threads are spread
+    // over a few depths; a pattern for each of the first twenty helpers, repeated for the next ones
+    constexpr std::array<int, 20> HELPER_SKIP_SIZE{ 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    constexpr std::array<int, 20> HELPER_SKIP_PHASE{ 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    // brings the highest scored of the remaining moves to the given index
+    PackedMove pickMove(MoveList& moves, std::array<int, MoveList::CAPACITY>& scores, std::size_t index) {
+        auto best = index;
+
+        for (auto i = index + 1; i < moves.size(); ++i) {
+            if (scores[i] > scores[best]) {
+                best = i;
+            }
+        }
+
+        std::swap(moves.begin()[index], moves.begin()[best]);
+        std::swap(scores[index], scores[best]);
+
+        return moves[index];
+    }
+
+    // mates are stored as the distance from the position, not from the root, so that they stay right wherever it is reached
+    int scoreToTable(int score, int ply) {
+        if (score > MATE_BOUND) {
+            return score + ply;
+        }
+
+        if (score < -MATE_BOUND) {
+            return score - ply;
+        }
+
+        return score;
+    }
+
+    int scoreFromTable(int score, int ply) {
+        if (score > MATE_BOUND) {
+            return score - ply;
+        }
+
+        if (score < -MATE_BOUND) {
+            return score + ply;
+        }
+
+        return score;
+    }
+}
+
+Searcher::Searcher() :
+    ownTable(std::make_unique<TranspositionTable>(DEFAULT_TABLE_MEGABYTES)),
+    table(ownTable.get()),
+    tableProbes(0),
+    tableHits(0),
+    nodes(0),
+    stopped(false),
+    stopRequested(false),
+    stopFlag(nullptr),
+    helperIndex(0),
+    previousPVLength(0)
+{}
+
+Searcher::Searcher(TranspositionTable& sharedTable) :
+    table(&sharedTable),
+    tableProbes(0),
+    tableHits(0),
+    nodes(0),
+    stopped(false),
+    stopRequested(false),
+    stopFlag(nullptr),
+    helperIndex(0),
+    previousPVLength(0)
+{}
+
+SearchResult Searcher::search(const Game& rootGame, const SearchLimits& searchLimits) {
+    // the copy reuses the capacity of the previous search, and the reserve covers the deepest line
+    game = rootGame;
+    game.moveHistory.clear();
+    game.moveHistory.reserve(MAX_SEARCH_PLY);
+    game.undoStack.reserve(game.undoStack.size() + MAX_SEARCH_PLY);
+
+    limits = searchLimits;
+    startTime = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+    stopRequested.store(false, std::memory_order_relaxed);
+
+    if (helperIndex == 0) {
+        table->newSearch();
+    }
+
+    tableProbes = 0;
+    tableHits = 0;
+
+    previousPVLength = 0;
+
+    for (auto& plyKillers : killers) {
+        plyKillers.fill(PackedMove());
+    }
+
+    for (auto& sideHistory : history) {
+        for (auto& fromHistory : sideHistory) {
+            fromHistory.fill(0);
+        }
+    }
+
+    SearchResult result{ .bestMove = PackedMove(), .score = 0, .depth = 0, .pv = {}, .nodes = 0, .elapsed = {}, .nodesPerSecond = 0 };
+
+    MoveList rootMoves;
+    game.generateLegalMoves(rootMoves);
+
+    if (rootMoves.empty()) {
+        result.score = game.isInCheck() ? -MATE_SCORE : 0;
+
+        return result;
+    }
+
+    // something to play even if the first iteration does not complete
+    result.bestMove = rootMoves[0];
+    result.pv.push_back(rootMoves[0]);
+
+    auto maxDepth = std::clamp(limits.depth, 1, MAX_SEARCH_DEPTH);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        if (helperIndex > 0) {
+            auto pattern = (helperIndex - 1) % HELPER_SKIP_SIZE.size();
+
+            if (((depth + HELPER_SKIP_PHASE[pattern]) / HELPER_SKIP_SIZE[pattern]) % 2 != 0) {
+                continue;
+            }
+        }
+
+        auto score = negamax(-INFINITE_SCORE, INFINITE_SCORE, depth, 0);
+
+        // a partial iteration is thrown away
+        if (stopped) {
+            break;
+        }
+
+        std::copy_n(pvTable[0].begin(), pvLength[0], previousPV.begin());
+        previousPVLength = pvLength[0];
+
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+        result.bestMove = pvTable[0][0];
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(pvTable[0].begin(), pvTable[0].begin() + pvLength[0]);
+        result.nodes = nodes;
+        result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+        result.nodesPerSecond = microseconds > 0 ? nodes * 1'000'000 / microseconds : 0;
+
+        if (iterationCallback) {
+            iterationCallback(result);
+        }
+
+        // a deeper search can not find a shorter mate
+        if (std::abs(score) > MATE_BOUND && MATE_SCORE - std::abs(score) <= depth) {
+            break;
+        }
+    }
+
+    table->addStatistics(tableProbes, tableHits);
+
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+    result.nodes = nodes;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    result.nodesPerSecond = microseconds > 0 ? nodes * 1'000'000 / microseconds : 0;
+
+    return result;
+}
+
+void Searcher::stop() {
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+void Searcher::setIterationCallback(IterationCallback callback) {
+    iterationCallback = std::move(callback);
+}
+
+void Searcher::setStopFlag(const std::atomic<bool>* flag) {
+    stopFlag = flag;
+}
+
+void Searcher::setHelperIndex(unsigned int index) {
+    helperIndex = index;
+}
+
+int Searcher::negamax(int alpha, int beta, int depth, int ply) {
+    pvLength[ply] = ply;
+
+    auto inCheck = game.isInCheck();
+
+    // a check is looked at one ply deeper, so that the search does not end on it
+    if (inCheck) {
+        ++depth;
+    }
+
+    if (depth <= 0) {
+        return quiescence(alpha, beta, ply);
+    }
+
+    if (countNode()) {
+        return 0;
+    }
+
+    if (ply > 0 && isDraw()) {
+        return 0;
+    }
+
+    if (ply >= MAX_SEARCH_PLY - 1) {
+        return evaluate();
+    }
+
+    auto key = game.hash();
+    auto pvNode = beta - alpha > 1;
+
+    TranspositionEntry entry;
+    auto tableMove = PackedMove();
+
+    ++tableProbes;
+
+    if (table->probe(key, entry)) {
+        ++tableHits;
+        tableMove = entry.move;
+
+        // the line of the principal variation is always searched, so that it can be reported in full
+        if (!pvNode && ply > 0 && entry.depth >= depth) {
+            auto score = scoreFromTable(entry.score, ply);
+
+            if (entry.bound == EXACT_BOUND
+                || (entry.bound == LOWER_BOUND && score >= beta)
+                || (entry.bound == UPPER_BOUND && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    MoveList moves;
+    game.generateLegalMoves(moves);
+
+    if (moves.empty()) {
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    std::array<int, MoveList::CAPACITY> scores;
+    scoreMoves(moves, scores, ply, tableMove);
+
+    auto originalAlpha = alpha;
+    auto bestScore = -INFINITE_SCORE;
+    auto bestMove = PackedMove();
+    auto side = colorIndex(game.currentPlayer);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        auto move = pickMove(moves, scores, i);
+        int score;
+
+        game.makeMove(move);
+        table->prefetch(game.hash());
+
+        // the first move is expected to be the best one, the others only have to be proven worse with a null window
+        if (i == 0) {
+            score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+        }
+        else {
+            score = -negamax(-alpha - 1, -alpha, depth - 1, ply + 1);
+
+            if (score > alpha && score < beta) {
+                score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+            }
+        }
+
+        game.undoMove();
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            bestMove = move;
+            updatePV(ply, move);
+        }
+
+        if (alpha >= beta) {
+            if (!move.isCapture() && !move.isPromotion()) {
+                if (killers[ply][0] != move) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = move;
+                }
+
+                auto& entry = history[side][move.from().index()][move.to().index()];
+                entry += depth * depth;
+
+                if (entry > HISTORY_LIMIT) {
+                    for (auto& fromHistory : history[side]) {
+                        for (auto& value : fromHistory) {
+                            value /= 2;
+                        }
+                    }
+                }
+            }
+
+            break;
+        }
+    }
+
+    auto bound = bestScore >= beta ? LOWER_BOUND : (bestScore > originalAlpha ? EXACT_BOUND : UPPER_BOUND);
+    table->store(key, bestMove, scoreToTable(bestScore, ply), depth, bound);
+
+    return bestScore;
+}
+
+int Searcher::quiescence(int alpha, int beta, int ply) {
+    pvLength[ply] = ply;
+
+    if (countNode()) {
+        return 0;
+    }
+
+    if (ply >= MAX_SEARCH_PLY - 1) {
+        return evaluate();
+    }
+
+    auto inCheck = game.isInCheck();
+    auto bestScore = -INFINITE_SCORE;
+
+    MoveList moves;
+
+    // in check every evasion is looked at, otherwise the side to move may stand pat and only captures are tried
+    if (inCheck) {
+        game.generateEvasions(moves);
+
+        if (moves.empty()) {
+            return -MATE_SCORE + ply;
+        }
+    }
+    else {
+        bestScore = evaluate();
+
+        if (bestScore >= beta) {
+            return bestScore;
+        }
+
+        alpha = std::max(alpha, bestScore);
+
+        game.generateCaptures(moves);
+    }
+
+    std::array<int, MoveList::CAPACITY> scores;
+    scoreMoves(moves, scores, ply, PackedMove());
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        auto move = pickMove(moves, scores, i);
+
+        game.makeMove(move);
+        auto score = -quiescence(-beta, -alpha, ply + 1);
+        game.undoMove();
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+        }
+
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return bestScore;
+}
+
+int Searcher::evaluate() const {
+    // a network set on the game takes over from the piece-square tables; kept clear of the mate scores
+    if (game.network) {
+        return std::clamp(game.evaluateNetwork(), -MATE_BOUND + 1, MATE_BOUND - 1);
+    }
+
+    return game.evaluate();
+}
+
+bool Searcher::isDraw() const {
+    if (game.halfmoveClock >= 100) {
+        return true;
+    }
+
+    // a position can only repeat with the same side to move, at least four plies apart and with no capture or pawn move in between
+    const auto& states = game.undoStack;
+    auto plies = std::min<std::size_t>(game.halfmoveClock, states.size());
+
+    for (std::size_t i = 4; i <= plies; i += 2) {
+        if (states[states.size() - i].positionKey == game.positionKey) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Searcher::scoreMoves(const MoveList& moves, std::array<int, MoveList::CAPACITY>& scores, int ply, PackedMove tableMove) const {
+    auto pvMove = ply < previousPVLength ? previousPV[ply] : PackedMove();
+    auto side = colorIndex(game.currentPlayer);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        auto move = moves[i];
+
+        if (move == tableMove) {
+            scores[i] = TABLE_MOVE_SCORE;
+        }
+        else if (move == pvMove) {
+            scores[i] = PV_MOVE_SCORE;
+        }
+        else if (move.isCapture() || move.isPromotion()) {
+            // most valuable victim first, then least valuable attacker
+            auto victim = move.isEnPassant() ? PAWN : pieceType(game.board[move.to().index()]);
+            auto attacker = pieceType(game.board[move.from().index()]);
+            auto promotion = move.isPromotion() ? PIECE_VALUES[move.promotionType()] : 0;
+
+            scores[i] = CAPTURE_SCORE + (move.isCapture() ? PIECE_VALUES[victim] * 8 : 0) + promotion - attacker;
+        }
+        else if (move == killers[ply][0]) {
+            scores[i] = FIRST_KILLER_SCORE;
+        }
+        else if (move == killers[ply][1]) {
+            scores[i] = SECOND_KILLER_SCORE;
+        }
+        else {
+            scores[i] = history[side][move.from().index()][move.to().index()];
+
+            // a few points of noise, the same for a move every time, is enough to send helpers down different subtrees
+            if (helperIndex > 0) {
+                scores[i] += ((move.raw() + 1) * 0x9E3779B1u * helperIndex) >> 26;
+            }
+        }
+    }
+}
+
+bool Searcher::countNode() {
+    ++nodes;
+
+    if (limits.nodes > 0 && nodes >= limits.nodes) {
+        stopped = true;
+    }
+
+    if (nodes % TIME_CHECK_INTERVAL == 0) {
+        if (stopRequested.load(std::memory_order_relaxed) || (stopFlag && stopFlag->load(std::memory_order_relaxed))) {
+            stopped = true;
+        }
+
+        if (limits.time > std::chrono::milliseconds::zero() && std::chrono::steady_clock::now() - startTime >= limits.time) {
+            stopped = true;
+        }
+    }
+
+    return stopped;
+}
+
+void Searcher::updatePV(int ply, PackedMove move) {
+    pvTable[ply][ply] = move;
+
+    for (auto i = ply + 1; i < pvLength[ply + 1]; ++i) {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+
+    pvLength[ply] = pvLength[ply + 1];
+}
+
+ParallelSearcher::ParallelSearcher(unsigned int threadCount, TranspositionTable& table) :
+    stopping(false)
+{
+    threadCount = std::max(threadCount, 1u);
+
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        auto& searcher = searchers.emplace_back(std::make_unique<Searcher>(table));
+
+        searcher->setStopFlag(&stopping);
+        searcher->setHelperIndex(i);
+    }
+
+    helperResults.resize(threadCount - 1);
+
+    if (threadCount > 1) {
+        pool = std::make_unique<ThreadPool>(threadCount - 1);
+    }
+}
+
+SearchResult ParallelSearcher::search(const Game& game, const SearchLimits& limits) {
+    // the flag is not cleared here: a `stop()` which came before the threads got going still ends this search
+    for (std::size_t i = 0; i < helperResults.size(); ++i) {
+        pool->submit([this, &game, i]() {
+            helperResults[i] = searchers[i + 1]->search(game, SearchLimits{});
+        });
+    }
+
+    auto result = searchers[0]->search(game, limits);
+
+    stopping.store(true, std::memory_order_relaxed);
+
+    if (pool) {
+        pool->wait();
+    }
+
+    // no thread reads the flag anymore, the next search starts afresh
+    stopping.store(false, std::memory_order_relaxed);
+
+    auto mainNodes = result.nodes;
+
+    for (const auto& helperResult : helperResults) {
+        if (helperResult.depth > result.depth && helperResult.bestMove != PackedMove()) {
+            result.bestMove = helperResult.bestMove;
+            result.score = helperResult.score;
+            result.depth = helperResult.depth;
+            result.pv = helperResult.pv;
+        }
+
+        result.nodes += helperResult.nodes;
+    }
+
+    // the rate of the main searcher, scaled up to the nodes of all the threads in the same time
+    if (mainNodes > 0) {
+        result.nodesPerSecond = static_cast<std::uint64_t>(static_cast<double>(result.nodesPerSecond) * result.nodes / mainNodes);
+    }
+
+    return result;
+}
+
+void ParallelSearcher::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+}
+
+void ParallelSearcher::setIterationCallback(Searcher::IterationCallback callback) {
+    searchers[0]->setIterationCallback(std::move(callback));
+}
+
+unsigned int ParallelSearcher::threadCount() const {
+    return static_cast<unsigned int>(searchers.size());
+}
@@ -0,0 +1,133 @@
+#include "chesslib/ThreadPool.hpp"
+
+namespace {
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local unsigned int currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount) :
+    pendingTasks(0),
+    queuedTasks(0),
+    nextQueue(0),
+    stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+
+    taskAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::size() const {
+    return static_cast<unsigned int>(workers.size());
+}
+
+void ThreadPool::submit(Task task) {
+    auto index = (currentPool == this) ? currentWorker : (nextQueue++ % size());
+
+    ++pendingTasks;
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    ++queuedTasks;
+
+    {
+        // pairs with the predicate check in `workerLoop()`, so a worker going to sleep can not miss this task
+        std::lock_guard<std::mutex> lock(stateMutex);
+    }
+
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+
+    allTasksDone.wait(lock, [this]() { return pendingTasks == 0; });
+}
+
+bool ThreadPool::popTask(unsigned int index, Task& task) {
+    auto& queue = *queues[index];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+
+    return true;
+}
+
+bool ThreadPool::stealTask(unsigned int index, Task& task) {
+    for (unsigned int offset = 1; offset < size(); ++offset) {
+        auto& queue = *queues[(index + offset) % size()];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        // the oldest task is the biggest one, as tasks split into smaller ones as they go
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        Task task;
+
+        if (popTask(index, task) || stealTask(index, task)) {
+            --queuedTasks;
+
+            task();
+
+            if (--pendingTasks == 0) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                allTasksDone.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+
+        taskAvailable.wait(lock, [this]() { return stopping || queuedTasks > 0; });
+
+        if (stopping && queuedTasks == 0) {
+            return;
+        }
+    }
+}
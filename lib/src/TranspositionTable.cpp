@@ -0,0 +1,231 @@
+#include "chesslib/TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace {
+    constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    constexpr int GENERATIONS = 64;
+
+    // entries of the table looked at by `fillPermille()`
+    constexpr std::size_t FILL_SAMPLE = 1000;
+
+    // entry data: move (16 bits) | score (16 bits) | depth (8 bits) | bound (2 bits) | generation (6 bits)
+    constexpr std::uint64_t packEntry(PackedMove move, int score, int depth, ScoreBound bound, std::uint8_t generation) {
+        return static_cast<std::uint64_t>(move.raw())
+            | (static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16)
+            | (static_cast<std::uint64_t>(std::clamp(depth, 0, 255)) << 32)
+            | (static_cast<std::uint64_t>(bound) << 40)
+            | (static_cast<std::uint64_t>(generation) << 42);
+    }
+
+    constexpr PackedMove entryMove(std::uint64_t data) {
+        return std::bit_cast<PackedMove>(static_cast<std::uint16_t>(data));
+    }
+
+    constexpr int entryScore(std::uint64_t data) {
+        return static_cast<std::int16_t>(data >> 16);
+    }
+
+    constexpr int entryDepth(std::uint64_t data) {
+        return static_cast<int>((data >> 32) & 0xFF);
+    }
+
+    constexpr ScoreBound entryBound(std::uint64_t data) {
+        return static_cast<ScoreBound>((data >> 40) & 3);
+    }
+
+    constexpr std::uint8_t entryGeneration(std::uint64_t data) {
+        return static_cast<std::uint8_t>((data >> 42) & (GENERATIONS - 1));
+    }
+}
+
+void TranspositionTable::FreeDeleter::operator()(Bucket* buckets) const {
+#if defined(_MSC_VER)
+    _aligned_free(buckets);
+#else
+    std::free(buckets);
+#endif
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes, bool hugePages) :
+    mask(0),
+    hugePages(false),
+    generation(0),
+    probeCount(0),
+    hitCount(0)
+{
+    resize(megabytes, hugePages);
+}
+
+void TranspositionTable::resize(std::size_t megabytes, bool useHugePages) {
+    // round down to a power of two, so that a bucket is picked by masking the key
+    auto count = std::bit_floor(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Bucket), 1));
+    auto bytes = count * sizeof(Bucket);
+    auto alignment = alignof(Bucket);
+
+    if (useHugePages) {
+        alignment = HUGE_PAGE_SIZE;
+        bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    buckets.reset();
+
+    // MSVC has no `std::aligned_alloc`, its own aligned memory goes back through `_aligned_free()`, see `FreeDeleter`
+#if defined(_MSC_VER)
+    auto memory = _aligned_malloc(bytes, alignment);
+#else
+    auto memory = std::aligned_alloc(alignment, bytes);
+#endif
+
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+
+    hugePages = false;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (useHugePages) {
+        hugePages = madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+    }
+#endif
+
+    buckets.reset(static_cast<Bucket*>(memory));
+    std::uninitialized_default_construct_n(buckets.get(), count);
+    mask = count - 1;
+
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        for (auto& entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    generation = 0;
+    probeCount = 0;
+    hitCount = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation.store((generation.load(std::memory_order_relaxed) + 1) % GENERATIONS, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TranspositionEntry& entry) const {
+    for (const auto& candidate : buckets[key & mask].entries) {
+        auto data = candidate.data.load(std::memory_order_relaxed);
+        auto check = candidate.check.load(std::memory_order_relaxed);
+
+        // an empty entry would match a zero key
+        if ((check ^ data) != key || entryBound(data) == NO_BOUND) {
+            continue;
+        }
+
+        entry = TranspositionEntry{
+            .move = entryMove(data),
+            .score = entryScore(data),
+            .depth = entryDepth(data),
+            .bound = entryBound(data)
+        };
+
+        return true;
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, PackedMove move, int score, int depth, ScoreBound bound) {
+    auto& bucket = buckets[key & mask];
+    auto currentGeneration = generation.load(std::memory_order_relaxed);
+
+    Entry* replaced = &bucket.entries[0];
+    auto replacedValue = INT_MAX;
+
+    for (auto& candidate : bucket.entries) {
+        auto data = candidate.data.load(std::memory_order_relaxed);
+        auto check = candidate.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && entryBound(data) != NO_BOUND) {
+            // a shallower bound of the same search does not push out a deeper result
+            if (bound != EXACT_BOUND && entryGeneration(data) == currentGeneration && depth + 2 < entryDepth(data)) {
+                return;
+            }
+
+            // a search which failed low has no move to suggest, the one found before is kept
+            if (move == PackedMove()) {
+                move = entryMove(data);
+            }
+
+            replaced = &candidate;
+            break;
+        }
+
+        // empty entries first, then the shallowest, eight plies of depth for every search gone by
+        auto age = (currentGeneration - entryGeneration(data) + GENERATIONS) % GENERATIONS;
+        auto value = entryBound(data) == NO_BOUND ? INT_MIN : entryDepth(data) - 8 * age;
+
+        if (value < replacedValue) {
+            replacedValue = value;
+            replaced = &candidate;
+        }
+    }
+
+    auto data = packEntry(move, score, depth, bound, currentGeneration);
+
+    replaced->check.store(key ^ data, std::memory_order_relaxed);
+    replaced->data.store(data, std::memory_order_relaxed);
+}
+
+std::size_t TranspositionTable::size() const {
+    return (mask + 1) * BUCKET_SIZE;
+}
+
+bool TranspositionTable::usesHugePages() const {
+    return hugePages;
+}
+
+void TranspositionTable::addStatistics(std::uint64_t probes, std::uint64_t hits) {
+    probeCount.fetch_add(probes, std::memory_order_relaxed);
+    hitCount.fetch_add(hits, std::memory_order_relaxed);
+}
+
+std::uint64_t TranspositionTable::probes() const {
+    return probeCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TranspositionTable::hits() const {
+    return hitCount.load(std::memory_order_relaxed);
+}
+
+int TranspositionTable::fillPermille() const {
+    auto sampledBuckets = std::min<std::size_t>(FILL_SAMPLE / BUCKET_SIZE, mask + 1);
+    auto currentGeneration = generation.load(std::memory_order_relaxed);
+    std::size_t filled = 0;
+
+    for (std::size_t i = 0; i < sampledBuckets; ++i) {
+        for (const auto& entry : buckets[i].entries) {
+            auto data = entry.data.load(std::memory_order_relaxed);
+
+            if (entryBound(data) != NO_BOUND && entryGeneration(data) == currentGeneration) {
+                ++filled;
+            }
+        }
+    }
+
+    return static_cast<int>(filled * 1000 / (sampledBuckets * BUCKET_SIZE));
+}
@@ -21,6 +21,22 @@ TEST(ApplyingMoveTest, PawnAdvancement) {
     // game->applyMove(game->parseMove("e4"));
     game->applyMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 4, .col = 'e' } });
 
-    EXPECT_EQ(game->serializeAsFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b - - 0 1")
+    EXPECT_EQ(game->serializeAsFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b - e3 0 1")
         << "Serialized board after applying a e4 move";
 }
+
+TEST(ApplyingMoveTest, CastlingOnlyFromEToGOrC) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+
+    game->applyMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true });
+
+    EXPECT_EQ(game->serializeAsFEN(), "4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1")
+        << "King stepping to f1 is not castling";
+
+    game->applyMove(Move{ .piece = WHITE_ROOK, .from = Position{.row = 1, .col = 'h' }, .to = Position{.row = 1, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true });
+
+    EXPECT_EQ(game->serializeAsFEN(), "4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1")
+        << "Only the king castles";
+}
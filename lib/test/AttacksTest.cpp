@@ -0,0 +1,49 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Attacks.hpp"
+
+TEST(AttacksTest, LeaperTablesAreCompileTimeConstants) {
+    static_assert(KNIGHT_ATTACKS[makeSquare(1, 'a').index()] == (squareBit(makeSquare(3, 'b')) | squareBit(makeSquare(2, 'c'))));
+    static_assert(popCount(KNIGHT_ATTACKS[makeSquare(4, 'e').index()]) == 8);
+    static_assert(popCount(KING_ATTACKS[makeSquare(8, 'h').index()]) == 3);
+    static_assert(PAWN_ATTACKS[colorIndex(WHITE)][makeSquare(2, 'h').index()] == squareBit(makeSquare(3, 'g')));
+    static_assert(PAWN_ATTACKS[colorIndex(BLACK)][makeSquare(7, 'a').index()] == squareBit(makeSquare(6, 'b')));
+
+    SUCCEED();
+}
+
+TEST(AttacksTest, LineTablesAreCompileTimeConstants) {
+    static_assert(BETWEEN[makeSquare(1, 'a').index()][makeSquare(4, 'd').index()] == (squareBit(makeSquare(2, 'b')) | squareBit(makeSquare(3, 'c'))));
+    static_assert(BETWEEN[makeSquare(1, 'a').index()][makeSquare(2, 'c').index()] == EMPTY_BITBOARD);
+    static_assert(BETWEEN[makeSquare(1, 'e').index()][makeSquare(1, 'f').index()] == EMPTY_BITBOARD);
+    static_assert(LINE[makeSquare(1, 'a').index()][makeSquare(2, 'c').index()] == EMPTY_BITBOARD);
+    static_assert(LINE[makeSquare(2, 'b').index()][makeSquare(3, 'c').index()] == 0x8040201008040201ULL);
+    static_assert(LINE[makeSquare(4, 'e').index()][makeSquare(8, 'e').index()] == 0x1010101010101010ULL);
+
+    SUCCEED();
+}
+
+TEST(AttacksTest, KnightDoesNotWrapAroundTheBoard) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/8/8/8/4K2N w - - 0 1");
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = WHITE_KNIGHT, .from = Position{.row = 1, .col = 'h' }, .to = Position{.row = 3, .col = 'i' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }));
+    EXPECT_TRUE(game->isValidMove(Move{ .piece = WHITE_KNIGHT, .from = Position{.row = 1, .col = 'h' }, .to = Position{.row = 3, .col = 'g' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }));
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = WHITE_KNIGHT, .from = Position{.row = 1, .col = 'h' }, .to = Position{.row = 2, .col = 'a' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }))
+        << "Square index h1 + 10 is a2, which is not a knight move away";
+}
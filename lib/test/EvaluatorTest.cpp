@@ -0,0 +1,87 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+namespace {
+    // walks the whole move tree, comparing the incrementally updated evaluation against the one computed from scratch,
+    // both after making the moves and after taking them back
+    void expectEvaluationsMatch(Game& game, int depth, const std::string& name) {
+        ASSERT_EQ(game.evaluate(), game.computeEvaluation()) << name;
+
+        if (depth == 0) {
+            return;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            auto before = game.evaluate();
+
+            game.makeMove(move);
+            expectEvaluationsMatch(game, depth - 1, name);
+            game.undoMove();
+
+            ASSERT_EQ(game.evaluate(), before) << name;
+        }
+    }
+}
+
+TEST(EvaluatorTest, IncrementalEvaluationMatchesComputed) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        expectEvaluationsMatch(*game, 3, position.name);
+    }
+}
+
+TEST(EvaluatorTest, Symmetry) {
+    auto game = std::make_unique<Game>();
+
+    EXPECT_EQ(game->evaluate(), 0);
+    EXPECT_EQ(game->evaluator.gamePhase(), MAX_PHASE);
+
+    auto other = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    other->parseFEN("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1");
+
+    EXPECT_EQ(game->evaluate(), other->evaluate())
+        << "The same position with the colors swapped scores the same for the side to move";
+}
+
+TEST(EvaluatorTest, TaperedByPhase) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+
+    EXPECT_EQ(game->evaluator.gamePhase(), 0);
+    EXPECT_EQ(game->evaluate(), game->evaluator.endgame())
+        << "Pawns and kings only, the endgame tables alone";
+
+    game->parseFEN("4k3/8/8/8/8/8/4P3/3QK3 w - - 0 1");
+
+    EXPECT_EQ(game->evaluator.gamePhase(), 4);
+    EXPECT_EQ(game->evaluate(), (game->evaluator.middlegame() * 4 + game->evaluator.endgame() * 20) / MAX_PHASE);
+
+    game->parseFEN("4k3/8/8/8/8/8/4P3/3QK3 b - - 0 1");
+
+    EXPECT_LT(game->evaluate(), -900)
+        << "Scored for the side to move";
+}
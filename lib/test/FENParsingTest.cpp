@@ -92,10 +92,10 @@ TEST(FENParsingTest, DefaultSetup) {
 
     EXPECT_EQ(game->currentPlayer, WHITE);
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, false);
 }
 
 TEST(FENParsingTest, ParsingCastlingAvailability) {
@@ -103,10 +103,10 @@ TEST(FENParsingTest, ParsingCastlingAvailability) {
 
     game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 0 8");
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, false);
 }
 
 TEST(FENParsingTest, ParsingCastlingAvailability2) {
@@ -114,10 +114,10 @@ TEST(FENParsingTest, ParsingCastlingAvailability2) {
 
     game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b - - 0 8");
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, false);
 }
 
 TEST(FENParsingTest, ParsingCastlingAvailability3) {
@@ -125,10 +125,10 @@ TEST(FENParsingTest, ParsingCastlingAvailability3) {
 
     game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kK - 0 8");
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, false);
 }
 
 TEST(FENParsingTest, ParsingCastlingAvailability4) {
@@ -136,10 +136,10 @@ TEST(FENParsingTest, ParsingCastlingAvailability4) {
 
     game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R w Qq - 0 8");
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, false);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, false);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, true);
 }
 
 TEST(FENParsingTest, ParsingCastlingAvailability5) {
@@ -147,10 +147,10 @@ TEST(FENParsingTest, ParsingCastlingAvailability5) {
 
     game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R w KQkq - 0 8");
 
-    EXPECT_EQ(game->castlingAvailability.BLACK_KING_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.BLACK_QUEEN_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.WHITE_KING_SIDE, true);
-    EXPECT_EQ(game->castlingAvailability.WHITE_QUEEN_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().BLACK_KING_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().BLACK_QUEEN_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().WHITE_KING_SIDE, true);
+    EXPECT_EQ(game->castlingAvailability().WHITE_QUEEN_SIDE, true);
 }
 
 TEST(FENParsingTest, ParsingCurrentPlayerBlack) {
@@ -168,3 +168,44 @@ TEST(FENParsingTest, ParsingCurrentPlayerWhite) {
 
     EXPECT_EQ(game->currentPlayer, WHITE);
 }
+
+TEST(FENParsingTest, ParsingEnPassantTarget) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+    EXPECT_EQ(game->enPassantSquare(), makeSquare(6, 'f'));
+
+    EXPECT_TRUE(game->isValidMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'e' }, .to = Position{.row = 6, .col = 'f' }, .promotion = std::nullopt, .isCapture = true, .isCastling = false }))
+        << "En passant is available right after parsing, without any move history";
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'e' }, .to = Position{.row = 6, .col = 'd' }, .promotion = std::nullopt, .isCapture = true, .isCastling = false }))
+        << "Only the square given in the FEN can be captured en passant";
+}
+
+TEST(FENParsingTest, ParsingEnPassantTargetWithoutPawn) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e6 0 1");
+
+    EXPECT_EQ(game->enPassantSquare(), std::nullopt)
+        << "En passant target without a pawn which could have skipped it is ignored";
+}
+
+TEST(FENParsingTest, ParsingMoveCounters) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 5 17");
+
+    EXPECT_EQ(game->halfmoveClock, 5);
+    EXPECT_EQ(game->fullmoveNumber, 17);
+}
+
+TEST(FENParsingTest, ParsingMissingMoveCounters) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq -");
+
+    EXPECT_EQ(game->halfmoveClock, 0);
+    EXPECT_EQ(game->fullmoveNumber, 1);
+}
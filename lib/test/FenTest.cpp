@@ -0,0 +1,198 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Fen.hpp"
+#include "chesslib/Perft.hpp"
+
+TEST(FenTest, ParsesAllFields) {
+    auto position = parseFENPosition("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w Kq f6 3 12");
+
+    ASSERT_TRUE(position.has_value());
+
+    EXPECT_EQ(position->pieceAt(makeSquare(1, 'a')), WHITE_ROOK);
+    EXPECT_EQ(position->pieceAt(makeSquare(5, 'e')), WHITE_PAWN);
+    EXPECT_EQ(position->pieceAt(makeSquare(8, 'e')), BLACK_KING);
+    EXPECT_EQ(position->pieceAt(makeSquare(4, 'e')), NONE);
+
+    EXPECT_EQ(position->currentPlayer, WHITE);
+    EXPECT_EQ(position->castlingRights, WHITE_KING_SIDE_CASTLING | BLACK_QUEEN_SIDE_CASTLING);
+    EXPECT_EQ(position->enPassantSquare(), makeSquare(6, 'f'));
+    EXPECT_EQ(position->halfmoveClock, 3);
+    EXPECT_EQ(position->fullmoveNumber, 12);
+}
+
+TEST(FenTest, MoveCountersAreOptional) {
+    auto position = parseFENPosition("4k3/8/8/8/8/8/8/4K3 b - -");
+
+    ASSERT_TRUE(position.has_value());
+
+    EXPECT_EQ(position->currentPlayer, BLACK);
+    EXPECT_EQ(position->halfmoveClock, 0);
+    EXPECT_EQ(position->fullmoveNumber, 1);
+}
+
+TEST(FenTest, RejectsMalformedFields) {
+    EXPECT_EQ(parseFENPosition("").error(), INVALID_PIECE_PLACEMENT);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1").error(), INVALID_PIECE_PLACEMENT);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1").error(), INVALID_PIECE_PLACEMENT);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/ppppXppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1").error(), INVALID_PIECE_PLACEMENT);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/ppppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1").error(), INVALID_PIECE_PLACEMENT);
+    EXPECT_EQ(parseFENPosition("8/8/8/8/8/8/8/8 w KQkq - 0 1").error(), INVALID_POSITION);
+    EXPECT_EQ(parseFENPosition("4k3/8/8/8/8/8/8/8 w - - 0 1").error(), INVALID_POSITION);
+    EXPECT_EQ(parseFENPosition("4k3/8/8/8/8/8/8/3KK3 w - - 0 1").error(), INVALID_POSITION);
+    EXPECT_EQ(parseFENPosition("P3k3/8/8/8/8/8/8/4K3 w - - 0 1").error(), INVALID_POSITION);
+    EXPECT_EQ(parseFENPosition("4k3/8/8/8/8/8/8/p3K3 b - - 0 1").error(), INVALID_POSITION);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR").error(), MISSING_FIELD);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1").error(), INVALID_SIDE_TO_MOVE);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq").error(), MISSING_FIELD);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KKq - 0 1").error(), INVALID_CASTLING_RIGHTS);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1").error(), INVALID_CASTLING_RIGHTS);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1").error(), INVALID_EN_PASSANT_TARGET);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq i6 0 1").error(), INVALID_EN_PASSANT_TARGET);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - x 1").error(), INVALID_HALFMOVE_CLOCK);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 70000 1").error(), INVALID_HALFMOVE_CLOCK);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 -1").error(), INVALID_FULLMOVE_NUMBER);
+    EXPECT_EQ(parseFENPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 bm e4").error(), TRAILING_CHARACTERS);
+}
+
+TEST(FenTest, DropsCastlingRightsWithoutTheirPieces) {
+    auto position = parseFENPosition("4k3/8/8/8/8/8/8/4K3 w KQkq - 0 1");
+
+    ASSERT_TRUE(position.has_value());
+    EXPECT_EQ(position->castlingRights, NO_CASTLING);
+
+    position = parseFENPosition("r3k3/8/8/8/8/8/8/4K2R w KQkq - 0 1");
+
+    ASSERT_TRUE(position.has_value());
+    EXPECT_EQ(position->castlingRights, WHITE_KING_SIDE_CASTLING | BLACK_QUEEN_SIDE_CASTLING);
+
+    position = parseFENPosition("r3k2r/8/8/8/8/8/8/R4K1R w KQkq - 0 1");
+
+    ASSERT_TRUE(position.has_value());
+    EXPECT_EQ(position->castlingRights, BLACK_KING_SIDE_CASTLING | BLACK_QUEEN_SIDE_CASTLING)
+        << "A king off its square keeps neither right";
+}
+
+TEST(FenTest, MalformedFENLeavesGameAsItWas) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    auto fen = game->serializeAsFEN();
+    auto hash = game->hash();
+
+    auto result = game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -- 0 1");
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), INVALID_EN_PASSANT_TARGET);
+
+    EXPECT_EQ(game->serializeAsFEN(), fen);
+    EXPECT_EQ(game->hash(), hash);
+}
+
+TEST(FenTest, BatchParsing) {
+    std::string buffer =
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+        "\n"
+        "not a FEN\r\n"
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1\r\n"
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1";
+
+    std::vector<PackedPosition> positions(2);
+
+    auto first = parseFENBatch(buffer, positions);
+
+    EXPECT_EQ(first.positions, 2);
+    EXPECT_EQ(first.errors, 1);
+
+    auto game = std::make_unique<Game>();
+
+    game->loadPosition(positions[1]);
+
+    EXPECT_EQ(game->serializeAsFEN(), "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    auto second = parseFENBatch(std::span<const char>(buffer).subspan(first.consumed), positions);
+
+    EXPECT_EQ(second.positions, 1)
+        << "The next batch continues after the last line taken, the last line needs no line break";
+    EXPECT_EQ(second.errors, 0);
+    EXPECT_EQ(first.consumed + second.consumed, buffer.size());
+
+    game->loadPosition(positions[0]);
+
+    EXPECT_EQ(game->serializeAsFEN(), "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+}
+
+TEST(FenTest, PackedPositionMatchesParsedGame) {
+    for (const auto& fen : {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"
+    }) {
+        auto fromPosition = std::make_unique<Game>();
+        auto fromString = std::make_unique<Game>();
+
+        fromPosition->loadPosition(*parseFENPosition(fen));
+        fromString->parseFEN(fen);
+
+        EXPECT_EQ(fromPosition->board, fromString->board);
+        EXPECT_EQ(fromPosition->hash(), fromString->hash());
+        EXPECT_EQ(fromPosition->serializeAsFEN(), fen);
+    }
+}
+
+TEST(FenTest, BatchSerializationRoundTrip) {
+    std::vector<PackedPosition> positions;
+
+    for (const auto& position : PERFT_POSITIONS) {
+        positions.push_back(*parseFENPosition(position.fen));
+    }
+
+    std::vector<char> buffer(positions.size() * (MAX_FEN_LENGTH + 1));
+
+    auto written = serializeFENBatch(positions, buffer);
+
+    EXPECT_EQ(written.positions, positions.size());
+
+    std::string expected;
+
+    for (const auto& position : PERFT_POSITIONS) {
+        expected += position.fen;
+        expected += '\n';
+    }
+
+    EXPECT_EQ(std::string_view(buffer.data(), written.written), expected);
+
+    std::vector<PackedPosition> parsed(positions.size());
+
+    auto read = parseFENBatch(std::span<const char>(buffer.data(), written.written), parsed);
+
+    EXPECT_EQ(read.positions, positions.size());
+    EXPECT_EQ(parsed, positions);
+}
+
+TEST(FenTest, BatchSerializationStopsWhenBufferIsFull) {
+    std::vector<PackedPosition> positions(3, *parseFENPosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1"));
+
+    // "4k3/8/8/8/8/8/8/4K3 w - - 0 1\n" is 30 bytes, so two of them fit
+    std::vector<char> buffer(70);
+
+    auto written = serializeFENBatch(positions, buffer);
+
+    EXPECT_EQ(written.positions, 2);
+    EXPECT_EQ(written.written, 60);
+}
@@ -0,0 +1,126 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+TEST(LegalityTest, Checkers) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+
+    EXPECT_EQ(game->checkers(), squareBit(makeSquare(6, 'b')))
+        << "Bishop on b6 checks the king on g1";
+
+    game->parseFEN(PERFT_POSITIONS[0].fen);
+
+    EXPECT_EQ(game->checkers(), EMPTY_BITBOARD);
+}
+
+TEST(LegalityTest, Pinned) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+
+    EXPECT_EQ(game->pinned(), squareBit(makeSquare(5, 'b')))
+        << "Pawn on b5 is pinned by the rook on h5";
+
+    EXPECT_EQ(game->pinRay(makeSquare(5, 'b')) & squareBit(makeSquare(6, 'b')), EMPTY_BITBOARD);
+    EXPECT_EQ(game->pinRay(makeSquare(4, 'b')), ALL_SQUARES);
+}
+
+TEST(LegalityTest, PinnedPieceCanNotLeaveTheLine) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+
+    auto push = Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'b' }, .to = Position{.row = 6, .col = 'b' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+
+    EXPECT_FALSE(game->isLegal(game->packMove(push)));
+    EXPECT_FALSE(game->isValidMove(push))
+        << "Validation rejects moves leaving the own king in check";
+}
+
+TEST(LegalityTest, MustAnswerTheCheck) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+
+    auto ignoresCheck = Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'h' }, .to = Position{.row = 3, .col = 'h' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+    auto blocksCheck = Move{ .piece = WHITE_PAWN, .from = Position{.row = 4, .col = 'c' }, .to = Position{.row = 5, .col = 'c' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+
+    EXPECT_FALSE(game->isLegal(game->packMove(ignoresCheck)));
+    EXPECT_TRUE(game->isLegal(game->packMove(blocksCheck)));
+}
+
+TEST(LegalityTest, GeneratedMovesAreLegalAndValid) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            auto unpacked = game->unpackMove(move);
+
+            EXPECT_TRUE(game->isLegal(move))
+                << position.name << ", " << unpacked.from << " -> " << unpacked.to;
+
+            EXPECT_TRUE(game->isValidMove(unpacked))
+                << position.name << ", " << unpacked.from << " -> " << unpacked.to;
+        }
+    }
+}
+
+TEST(LegalityTest, GeneratedRepliesAreValid) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            game->makeMove(move);
+
+            MoveList replies;
+            game->generateLegalMoves(replies);
+
+            for (auto reply : replies) {
+                auto unpacked = game->unpackMove(reply);
+
+                EXPECT_TRUE(game->isValidMove(unpacked))
+                    << position.name << ", " << unpacked.from << " -> " << unpacked.to;
+            }
+
+            game->undoMove();
+        }
+    }
+}
+
+TEST(LegalityTest, OnlyTheSideToMoveCanMove) {
+    auto game = std::make_unique<Game>();
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = BLACK_PAWN, .from = Position{.row = 7, .col = 'e' }, .to = Position{.row = 5, .col = 'e' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }))
+        << "Black pawn can not move while it is white to move";
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = BLACK_KNIGHT, .from = Position{.row = 8, .col = 'g' }, .to = Position{.row = 6, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }))
+        << "Black knight can not move while it is white to move";
+
+    EXPECT_TRUE(game->isValidMove(Move{ .piece = WHITE_KNIGHT, .from = Position{.row = 1, .col = 'g' }, .to = Position{.row = 3, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }));
+}
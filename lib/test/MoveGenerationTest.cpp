@@ -0,0 +1,147 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+
+TEST(MoveGenerationTest, StartPosition) {
+    auto game = std::make_unique<Game>();
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(moves.size(), 20)
+        << "16 pawn moves and 4 knight moves from the start position";
+}
+
+TEST(MoveGenerationTest, Kiwipete) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(moves.size(), 48);
+
+    EXPECT_TRUE(moves.contains(game->packMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'g' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true })))
+        << "Short castling is available";
+
+    EXPECT_TRUE(moves.contains(game->packMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'c' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true })))
+        << "Long castling is available";
+}
+
+TEST(MoveGenerationTest, CapturesAndQuietsPartitionLegalMoves) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    MoveList captures;
+    game->generateCaptures(captures);
+
+    MoveList quiets;
+    game->generateQuiets(quiets);
+
+    EXPECT_EQ(captures.size(), 8);
+    EXPECT_EQ(quiets.size(), 40);
+
+    for (const auto& move : captures) {
+        EXPECT_TRUE(move.isCapture());
+    }
+
+    for (const auto& move : quiets) {
+        EXPECT_FALSE(move.isCapture());
+    }
+}
+
+TEST(MoveGenerationTest, Evasions) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+
+    ASSERT_TRUE(game->isInCheck());
+
+    MoveList evasions;
+    game->generateEvasions(evasions);
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(evasions.size(), 6);
+    EXPECT_EQ(moves.size(), 6);
+}
+
+TEST(MoveGenerationTest, NoEvasionsWhenNotInCheck) {
+    auto game = std::make_unique<Game>();
+
+    MoveList evasions;
+    game->generateEvasions(evasions);
+
+    EXPECT_TRUE(evasions.empty());
+}
+
+TEST(MoveGenerationTest, PinnedPieces) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(moves.size(), 14);
+
+    EXPECT_FALSE(moves.contains(game->packMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'b' }, .to = Position{.row = 6, .col = 'b' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false })))
+        << "Pawn on b5 is pinned by the rook on h5";
+}
+
+TEST(MoveGenerationTest, Promotions) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(moves.size(), 44);
+
+    EXPECT_TRUE(moves.contains(game->packMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 7, .col = 'd' }, .to = Position{.row = 8, .col = 'c' }, .promotion = WHITE_KNIGHT, .isCapture = true, .isCastling = false })))
+        << "Pawn can capture on c8 promoting to a knight";
+}
+
+TEST(MoveGenerationTest, EnPassant) {
+    auto game = std::make_unique<Game>();
+
+    game->applyMove(*game->parseMove("e4"));
+    game->applyMove(*game->parseMove("b6"));
+    game->applyMove(*game->parseMove("e5"));
+    game->applyMove(*game->parseMove("d5"));
+
+    MoveList captures;
+    game->generateCaptures(captures);
+
+    EXPECT_TRUE(captures.contains(game->packMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'e' }, .to = Position{.row = 6, .col = 'd' }, .promotion = std::nullopt, .isCapture = true, .isCastling = false })))
+        << "En passant capture is generated right after a two-rank advancement";
+}
+
+TEST(MoveGenerationTest, KingOnlyPosition) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("8/8/8/8/4K3/8/8/8 w KQkq - 0 1");
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_EQ(moves.size(), 8)
+        << "Lone king in the center has 8 moves and castling rights without rooks are ignored";
+}
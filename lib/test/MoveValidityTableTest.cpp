@@ -0,0 +1,109 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+
+TEST(MoveValidityTableTest, KindsOfMovesAreKeptApart) {
+    MoveValidityTable table;
+
+    auto quiet = PackedMove(makeSquare(2, 'e'), makeSquare(3, 'f'), QUIET_MOVE);
+    auto capture = PackedMove(makeSquare(2, 'e'), makeSquare(3, 'f'), CAPTURE);
+
+    table.store(capture, true);
+
+    EXPECT_THAT(table.find(capture), Optional(true));
+    EXPECT_EQ(table.find(quiet), std::nullopt)
+        << "Same squares, but not a capture";
+
+    table.store(quiet, false);
+
+    EXPECT_THAT(table.find(quiet), Optional(false));
+    EXPECT_THAT(table.find(capture), Optional(true));
+
+    table.clear();
+
+    EXPECT_EQ(table.find(capture), std::nullopt);
+}
+
+TEST(MoveValidityTableTest, Promotions) {
+    MoveValidityTable table;
+
+    auto queen = PackedMove(makeSquare(7, 'd'), makeSquare(8, 'c'), QUEEN_PROMOTION_CAPTURE);
+    auto knight = PackedMove(makeSquare(7, 'd'), makeSquare(8, 'c'), KNIGHT_PROMOTION_CAPTURE);
+    auto impossible = PackedMove(makeSquare(4, 'd'), makeSquare(5, 'd'), QUEEN_PROMOTION);
+
+    table.store(queen, true);
+    table.store(knight, false);
+    table.store(impossible, true);
+
+    EXPECT_THAT(table.find(queen), Optional(true));
+    EXPECT_THAT(table.find(knight), Optional(false));
+    EXPECT_EQ(table.find(impossible), std::nullopt)
+        << "Promotions away from the last rank are never memoized";
+}
+
+TEST(MoveValidityTableTest, PromotionToTheWrongColorIsNotMemoized) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+
+    auto promotion = Move{ .piece = WHITE_PAWN, .from = Position{.row = 7, .col = 'a' }, .to = Position{.row = 8, .col = 'a' }, .promotion = WHITE_QUEEN, .isCapture = false, .isCastling = false };
+    auto wrongColor = Move{ .piece = WHITE_PAWN, .from = Position{.row = 7, .col = 'a' }, .to = Position{.row = 8, .col = 'a' }, .promotion = BLACK_QUEEN, .isCapture = false, .isCastling = false };
+    auto wrongPiece = Move{ .piece = WHITE_PAWN, .from = Position{.row = 7, .col = 'a' }, .to = Position{.row = 8, .col = 'a' }, .promotion = WHITE_KING, .isCapture = false, .isCastling = false };
+
+    EXPECT_TRUE(game->isValidMove(promotion));
+    EXPECT_FALSE(game->isValidMove(wrongColor))
+        << "Promotion to a black queen does not share the result of the one to a white queen";
+    EXPECT_FALSE(game->isValidMove(wrongPiece));
+    EXPECT_TRUE(game->isValidMove(promotion));
+}
+
+TEST(MoveValidityTableTest, CastlingFlagOnAKingStepIsNotMemoized) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/8/8/8/4K2R w K - 0 1");
+
+    auto flagged = Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true };
+    auto step = Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+
+    EXPECT_FALSE(game->isValidMove(flagged));
+    EXPECT_TRUE(game->isValidMove(step))
+        << "Refused castling to f1 does not make the plain king step invalid";
+}
+
+TEST(MoveValidityTableTest, ResetWhenThePositionChanges) {
+    auto game = std::make_unique<Game>();
+
+    auto push = Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 4, .col = 'e' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+
+    EXPECT_TRUE(game->isValidMove(push));
+    EXPECT_TRUE(game->isValidMove(push));
+
+    game->setPieceAt(3, 'e', BLACK_KNIGHT);
+
+    EXPECT_FALSE(game->isValidMove(push))
+        << "Knight blocking the pawn is seen by the validation after the board changes";
+}
+
+TEST(MoveValidityTableTest, WrongPieceIsNotMemoized) {
+    auto game = std::make_unique<Game>();
+
+    auto knightMove = Move{ .piece = WHITE_KNIGHT, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 3, .col = 'e' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+    auto pawnMove = Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 3, .col = 'e' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false };
+
+    EXPECT_FALSE(game->isValidMove(knightMove));
+    EXPECT_TRUE(game->isValidMove(pawnMove))
+        << "Result for a knight claimed to stand on e2 does not leak into the pawn on e2";
+}
@@ -0,0 +1,202 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Network.hpp"
+#include "chesslib/Perft.hpp"
+#include "chesslib/Search.hpp"
+
+namespace {
+    // walks the whole move tree, comparing the incrementally updated accumulator bit for bit against one refreshed
+    // from the board, both after making the moves and after taking them back
+    void expectAccumulatorsMatch(Game& game, const Network& network, int depth, const std::string& name) {
+        auto score = game.evaluateNetwork();
+
+        Accumulator refreshed;
+        network.refreshAccumulator(refreshed, WHITE, game.pieceBitboards);
+        network.refreshAccumulator(refreshed, BLACK, game.pieceBitboards);
+
+        ASSERT_EQ(game.accumulator.values, refreshed.values) << name;
+
+        if (depth == 0) {
+            return;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            game.makeMove(move);
+            expectAccumulatorsMatch(game, network, depth - 1, name);
+            game.undoMove();
+
+            ASSERT_EQ(game.evaluateNetwork(), score) << name;
+        }
+    }
+}
+
+TEST(NetworkTest, IncrementalAccumulatorMatchesRefresh) {
+    auto network = Network::random(1);
+
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->setNetwork(network.get());
+        game->parseFEN(position.fen);
+
+        expectAccumulatorsMatch(*game, *network, 3, position.name);
+    }
+}
+
+TEST(NetworkTest, SimdPathsMatchScalar) {
+    auto network = Network::random(2);
+    auto game = std::make_unique<Game>();
+
+    game->setNetwork(network.get());
+
+    for (const auto& position : PERFT_POSITIONS) {
+        game->parseFEN(position.fen);
+
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            ASSERT_TRUE(network->setSimdLevel(NO_SIMD));
+
+            game->makeMove(move);
+            game->setNetwork(network.get());
+
+            auto expected = game->evaluateNetwork();
+            auto expectedAccumulator = game->accumulator.values;
+
+            game->undoMove();
+
+            for (auto level : { SSE41_SIMD, AVX2_SIMD }) {
+                if (!network->setSimdLevel(level)) {
+                    continue;
+                }
+
+                // refreshed before the move, then updated by it
+                game->setNetwork(network.get());
+                game->evaluateNetwork();
+                game->makeMove(move);
+
+                EXPECT_EQ(game->evaluateNetwork(), expected) << position.name << ", SIMD level " << level;
+                EXPECT_EQ(game->accumulator.values, expectedAccumulator) << position.name << ", SIMD level " << level;
+
+                game->undoMove();
+            }
+        }
+    }
+}
+
+TEST(NetworkTest, Symmetry) {
+    auto network = Network::random(3);
+    auto game = std::make_unique<Game>();
+    auto other = std::make_unique<Game>();
+
+    game->setNetwork(network.get());
+    other->setNetwork(network.get());
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    other->parseFEN("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1");
+
+    EXPECT_EQ(game->evaluateNetwork(), other->evaluateNetwork())
+        << "Both sides see the board from their own side";
+}
+
+TEST(NetworkTest, SaveAndLoad) {
+    auto network = Network::random(4);
+    auto data = network->serialize();
+
+    auto parsed = Network::parse(data);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ((*parsed)->serialize(), data);
+
+    auto path = (std::filesystem::temp_directory_path() / "chesslib-network-test.nnue").string();
+
+    ASSERT_TRUE(network->save(path));
+
+    auto loaded = Network::load(path);
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(loaded.has_value());
+
+    auto game = std::make_unique<Game>();
+    auto other = std::make_unique<Game>();
+
+    game->setNetwork(network.get());
+    other->setNetwork(loaded->get());
+
+    for (const auto& position : PERFT_POSITIONS) {
+        game->parseFEN(position.fen);
+        other->parseFEN(position.fen);
+
+        EXPECT_EQ(game->evaluateNetwork(), other->evaluateNetwork()) << position.name;
+    }
+}
+
+TEST(NetworkTest, LoadErrors) {
+    auto data = Network::random(5)->serialize();
+
+    EXPECT_EQ(Network::load("/nonexistent/network.nnue").error(), NETWORK_FILE_UNREADABLE);
+
+    EXPECT_EQ(Network::parse(std::span<const char>()).error(), INVALID_NETWORK_HEADER);
+    EXPECT_EQ(Network::parse(std::span(data).first(10)).error(), INVALID_NETWORK_HEADER);
+
+    auto truncated = std::span(data).first(data.size() - 1);
+    EXPECT_EQ(Network::parse(truncated).error(), TRUNCATED_NETWORK);
+
+    auto trailing = data;
+    trailing.push_back(0);
+    EXPECT_EQ(Network::parse(trailing).error(), TRAILING_NETWORK_DATA);
+
+    auto otherMagic = data;
+    otherMagic[0] = 'X';
+    EXPECT_EQ(Network::parse(otherMagic).error(), INVALID_NETWORK_HEADER);
+
+    auto otherShape = data;
+    otherShape[4 * 4] ^= 1;
+    EXPECT_EQ(Network::parse(otherShape).error(), INVALID_NETWORK_HEADER)
+        << "A network of another size is refused";
+
+    EXPECT_EQ(networkErrorMessage(TRUNCATED_NETWORK), "truncated network");
+}
+
+TEST(NetworkTest, WithoutNetwork) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    EXPECT_EQ(game->evaluateNetwork(), game->evaluate())
+        << "Without a network the piece-square evaluation is used";
+}
+
+TEST(NetworkTest, SearchWithNetwork) {
+    auto network = Network::random(6);
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->setNetwork(network.get());
+    game->parseFEN("k7/8/8/8/8/8/1R6/2R3K1 w - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Ra1"));
+    EXPECT_EQ(result.score, MATE_SCORE - 1)
+        << "Mates are found whatever the evaluation";
+}
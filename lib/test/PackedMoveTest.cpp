@@ -0,0 +1,81 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+TEST(PackedMoveTest, Size) {
+    EXPECT_EQ(sizeof(PackedMove), 2);
+}
+
+TEST(PackedMoveTest, Fields) {
+    auto move = PackedMove(makeSquare(7, 'd'), makeSquare(8, 'c'), KNIGHT_PROMOTION_CAPTURE);
+
+    EXPECT_EQ(move.from(), makeSquare(7, 'd'));
+    EXPECT_EQ(move.to(), makeSquare(8, 'c'));
+    EXPECT_TRUE(move.isCapture());
+    EXPECT_TRUE(move.isPromotion());
+    EXPECT_EQ(move.promotionType(), KNIGHT);
+    EXPECT_FALSE(move.isCastling());
+    EXPECT_FALSE(move.isEnPassant());
+}
+
+TEST(PackedMoveTest, PromotionToMove) {
+    auto move = PackedMove(makeSquare(2, 'b'), makeSquare(1, 'a'), QUEEN_PROMOTION_CAPTURE);
+
+    EXPECT_EQ(move.toMove(BLACK_PAWN), (Move{ .piece = BLACK_PAWN, .from = Position{.row = 2, .col = 'b' }, .to = Position{.row = 1, .col = 'a' }, .promotion = BLACK_QUEEN, .isCapture = true, .isCastling = false }))
+        << "Promoted piece takes the color of the pawn";
+}
+
+TEST(PackedMoveTest, RoundTripsAllLegalMoves) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            auto unpacked = game->unpackMove(move);
+
+            EXPECT_EQ(game->packMove(unpacked), move)
+                << position.name << ", " << unpacked.from << " -> " << unpacked.to;
+        }
+    }
+}
+
+TEST(PackedMoveTest, EnPassantAndDoublePush) {
+    auto game = std::make_unique<Game>();
+
+    game->applyMove(*game->parseMove("e4"));
+
+    ASSERT_EQ(game->moveHistory.size(), 1);
+    EXPECT_TRUE(game->moveHistory.back().isDoublePawnPush());
+
+    game->applyMove(*game->parseMove("b6"));
+    game->applyMove(*game->parseMove("e5"));
+    game->applyMove(*game->parseMove("d5"));
+
+    auto capture = game->packMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'e' }, .to = Position{.row = 6, .col = 'd' }, .promotion = std::nullopt, .isCapture = true, .isCastling = false });
+
+    EXPECT_TRUE(capture.isEnPassant());
+
+    game->makeMove(capture);
+
+    EXPECT_EQ(game->pieceAt(6, 'd'), WHITE_PAWN);
+    EXPECT_EQ(game->pieceAt(5, 'd'), NONE)
+        << "Pawn captured en passant is removed";
+}
@@ -204,5 +204,80 @@ TEST(ParsingMoveTest, ParsingCastling4) {
     EXPECT_EQ(move4->isCapture, false);
     EXPECT_EQ(move4->piece, BLACK_KING);
     EXPECT_THAT(move4->from, FieldsAre(Eq(8), Eq('e')));
-    EXPECT_THAT(move4->to, FieldsAre(Eq(8), Eq('b')));
+    EXPECT_THAT(move4->to, FieldsAre(Eq(8), Eq('c')));
+}
+
+TEST(ParsingMoveTest, DisambiguatingByRank) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/R7/8/8/8/8/R3K3 w - - 0 1");
+
+    auto move = game->parseMove("R1a3");
+
+    ASSERT_NE(move, std::nullopt);
+
+    EXPECT_EQ(move->piece, WHITE_ROOK);
+    EXPECT_THAT(move->from, FieldsAre(Eq(1), Eq('a')));
+    EXPECT_THAT(move->to, FieldsAre(Eq(3), Eq('a')));
+
+    EXPECT_EQ(game->parseMove("Ra3"), std::nullopt)
+        << "Both rooks can move to a3";
+}
+
+TEST(ParsingMoveTest, DisambiguatingByFileAndRank) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/3p4/8/8/Q5Q1/8/8/Q3K3 w - - 0 1");
+
+    auto move = game->parseMove("Qa4d1");
+
+    ASSERT_NE(move, std::nullopt);
+
+    EXPECT_THAT(move->from, FieldsAre(Eq(4), Eq('a')));
+    EXPECT_THAT(move->to, FieldsAre(Eq(1), Eq('d')));
+
+    EXPECT_EQ(game->parseMove("Qad1"), std::nullopt)
+        << "Two queens on the a file can move to d1";
+    EXPECT_EQ(game->parseMove("Q4d1"), std::nullopt)
+        << "Two queens on the 4th rank can move to d1";
+}
+
+TEST(ParsingMoveTest, ParsingPromotions) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+    for (const auto* notation : { "dxc8=N", "dxc8N", "dxc8=N+", "dc8N" }) {
+        auto move = game->parseMove(notation);
+
+        ASSERT_NE(move, std::nullopt) << notation;
+
+        EXPECT_EQ(move->promotion, WHITE_KNIGHT) << notation;
+        EXPECT_TRUE(move->isCapture) << notation;
+        EXPECT_THAT(move->to, FieldsAre(Eq(8), Eq('c'))) << notation;
+    }
+
+    EXPECT_EQ(game->parseMove("dxc8"), std::nullopt)
+        << "Promotion has to name the piece";
+}
+
+TEST(ParsingMoveTest, IgnoringSuffixes) {
+    auto game = std::make_unique<Game>();
+
+    for (const auto* notation : { "Nf3+", "Nf3#", "Nf3!?", "Nf3??", "Ng1f3", "Ng1-f3" }) {
+        auto move = game->parseMove(notation);
+
+        ASSERT_NE(move, std::nullopt) << notation;
+
+        EXPECT_THAT(move->from, FieldsAre(Eq(1), Eq('g'))) << notation;
+        EXPECT_THAT(move->to, FieldsAre(Eq(3), Eq('f'))) << notation;
+    }
+}
+
+TEST(ParsingMoveTest, RejectingMalformedMoves) {
+    auto game = std::make_unique<Game>();
+
+    for (const auto* notation : { "", "+", "N", "Nf", "Nf9", "Ni3", "Nzf3", "e5", "O-O", "Ke2" }) {
+        EXPECT_EQ(game->parseMove(notation), std::nullopt) << notation;
+    }
 }
@@ -0,0 +1,111 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+TEST(PerftTest, ReferencePositions) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        for (int depth = 1; depth <= 3; ++depth) {
+            EXPECT_EQ(perft(*game, depth), position.nodes[depth - 1])
+                << position.name << ", depth " << depth;
+        }
+    }
+}
+
+TEST(PerftTest, Kiwipete) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN(PERFT_POSITIONS[1].fen);
+
+    EXPECT_EQ(perft(*game, 4), 4085603)
+        << "Castling, en passant and promotions at depth 4";
+}
+
+TEST(PerftTest, MakeMoveKeepsBoardConsistent) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    game->makeMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'c' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true });
+
+    EXPECT_EQ(game->pieceAt(1, 'c'), WHITE_KING);
+    EXPECT_EQ(game->pieceAt(1, 'd'), WHITE_ROOK);
+    EXPECT_EQ(game->pieceAt(1, 'a'), NONE);
+    EXPECT_EQ(game->pieceAt(1, 'e'), NONE);
+
+    EXPECT_FALSE(game->castlingAvailability().WHITE_KING_SIDE);
+    EXPECT_FALSE(game->castlingAvailability().WHITE_QUEEN_SIDE);
+    EXPECT_TRUE(game->castlingAvailability().BLACK_KING_SIDE);
+    EXPECT_TRUE(game->castlingAvailability().BLACK_QUEEN_SIDE);
+
+    EXPECT_EQ(game->currentPlayer, BLACK);
+}
+
+TEST(PerftTest, ThreadedDivideMatchesSingleThreaded) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN(PERFT_POSITIONS[1].fen);
+
+    ThreadPool pool(4);
+
+    auto expected = perftDivide(*game, 3);
+    auto actual = perftDivide(*game, 3, pool, 2);
+
+    ASSERT_EQ(actual.size(), expected.size());
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].move, expected[i].move);
+        EXPECT_EQ(actual[i].nodes, expected[i].nodes);
+    }
+}
+
+TEST(PerftTest, HashedCountsMatchUnhashed) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN(PERFT_POSITIONS[1].fen);
+
+    // a tiny table, so that most of the entries get overwritten along the way
+    PerftTable table(1);
+
+    EXPECT_EQ(perft(*game, 4, table), 4085603);
+    EXPECT_GT(table.hits(), 0);
+
+    EXPECT_EQ(perft(*game, 4, table), 4085603)
+        << "Counts stay the same when read back from a filled table";
+}
+
+TEST(PerftTest, ThreadedHashedDivideMatchesSingleThreaded) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN(PERFT_POSITIONS[2].fen);
+
+    ThreadPool pool(4);
+    PerftTable table(4);
+
+    auto expected = perftDivide(*game, 5);
+    auto actual = perftDivide(*game, 5, pool, 2, &table);
+
+    ASSERT_EQ(actual.size(), expected.size());
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].move, expected[i].move);
+        EXPECT_EQ(actual[i].nodes, expected[i].nodes);
+    }
+}
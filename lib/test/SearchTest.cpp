@@ -0,0 +1,223 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Search.hpp"
+
+TEST(SearchTest, MateInOne) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("k7/8/8/8/8/8/1R6/2R3K1 w - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Ra1"));
+    EXPECT_EQ(result.score, MATE_SCORE - 1);
+}
+
+TEST(SearchTest, MateInTwo) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("1k6/8/8/8/8/8/R7/6RK w - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 5 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Rg7"));
+    EXPECT_EQ(result.score, MATE_SCORE - 3);
+    EXPECT_LE(result.depth, 3)
+        << "The search stops once no deeper iteration can find a shorter mate";
+
+    ASSERT_EQ(result.pv.size(), 3);
+    EXPECT_EQ(game->serializeMove(game->unpackMove(result.pv[0])), "Rg7");
+}
+
+TEST(SearchTest, CapturesHangingPiece) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 4 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Rxd5"));
+    EXPECT_GT(result.score, 400);
+
+    game->parseFEN("4k3/8/8/3q4/8/2P5/8/3RK3 b - - 0 1");
+
+    result = searcher->search(*game, SearchLimits{ .depth = 4 });
+
+    EXPECT_NE(result.bestMove, *game->parsePackedMove("Qxd1+"))
+        << "The queen does not take a defended rook";
+}
+
+TEST(SearchTest, NoLegalMoves) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_EQ(result.bestMove, PackedMove())
+        << "Stalemate";
+    EXPECT_EQ(result.score, 0);
+
+    game->parseFEN("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1");
+
+    result = searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_EQ(result.bestMove, PackedMove())
+        << "Checkmate";
+    EXPECT_EQ(result.score, -MATE_SCORE);
+}
+
+TEST(SearchTest, RepetitionIsADraw) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("4k3/8/8/8/8/8/QQ6/4K3 w - - 0 1");
+
+    for (auto move : { "Qa3", "Kd8", "Qa2" }) {
+        game->makeMove(*game->parseMove(move));
+    }
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 4 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Ke8"))
+        << "Two queens down, black goes back to the position the game started from";
+    EXPECT_EQ(result.score, 0);
+}
+
+TEST(SearchTest, PrincipalVariationIsLegal) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 4 });
+
+    EXPECT_EQ(result.depth, 4);
+    EXPECT_GT(result.nodes, 0);
+
+    ASSERT_FALSE(result.pv.empty());
+    EXPECT_EQ(result.pv[0], result.bestMove);
+
+    for (auto move : result.pv) {
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        ASSERT_TRUE(moves.contains(move));
+
+        game->makeMove(move);
+    }
+}
+
+TEST(SearchTest, Limits) {
+    auto game = std::make_unique<Game>();
+    auto searcher = std::make_unique<Searcher>();
+
+    auto result = searcher->search(*game, SearchLimits{ .nodes = 5000 });
+
+    EXPECT_LE(result.nodes, 5000);
+    EXPECT_NE(result.bestMove, PackedMove())
+        << "A move is returned even when the limit cuts the search short";
+
+    result = searcher->search(*game, SearchLimits{ .time = std::chrono::milliseconds(50) });
+
+    EXPECT_LT(result.elapsed, std::chrono::milliseconds(1000));
+    EXPECT_GE(result.depth, 1);
+
+    std::vector<int> depths;
+
+    searcher->setIterationCallback([&depths](const SearchResult& iteration) {
+        depths.push_back(iteration.depth);
+    });
+
+    searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_THAT(depths, ::testing::ElementsAre(1, 2, 3));
+}
+
+TEST(SearchTest, ParallelSearch) {
+    auto game = std::make_unique<Game>();
+    auto table = std::make_unique<TranspositionTable>(4);
+    auto searcher = std::make_unique<ParallelSearcher>(4, *table);
+
+    EXPECT_EQ(searcher->threadCount(), 4);
+
+    game->parseFEN("1k6/8/8/8/8/8/R7/6RK w - - 0 1");
+
+    auto result = searcher->search(*game, SearchLimits{ .depth = 5 });
+
+    EXPECT_EQ(result.bestMove, *game->parsePackedMove("Rg7"));
+    EXPECT_EQ(result.score, MATE_SCORE - 3);
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    result = searcher->search(*game, SearchLimits{ .depth = 5 });
+
+    EXPECT_GE(result.depth, 5);
+    ASSERT_FALSE(result.pv.empty());
+    EXPECT_EQ(result.pv[0], result.bestMove);
+
+    MoveList moves;
+    game->generateLegalMoves(moves);
+
+    EXPECT_TRUE(moves.contains(result.bestMove));
+}
+
+TEST(SearchTest, StoppingParallelSearch) {
+    auto game = std::make_unique<Game>();
+    auto table = std::make_unique<TranspositionTable>(4);
+    auto searcher = std::make_unique<ParallelSearcher>(3, *table);
+
+    auto result = searcher->search(*game, SearchLimits{ .time = std::chrono::milliseconds(50) });
+
+    EXPECT_LT(result.elapsed, std::chrono::milliseconds(1000))
+        << "The main thread owns the time budget and stops the helpers";
+    EXPECT_NE(result.bestMove, PackedMove());
+
+    SearchResult stoppedResult;
+
+    std::thread thread([&]() {
+        stoppedResult = searcher->search(*game, SearchLimits{});
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    searcher->stop();
+    thread.join();
+
+    EXPECT_GE(stoppedResult.depth, 1);
+    EXPECT_NE(stoppedResult.bestMove, PackedMove());
+
+    // a stop which comes before the search is not lost
+    searcher->stop();
+
+    auto earlyStoppedResult = searcher->search(*game, SearchLimits{});
+
+    EXPECT_LT(earlyStoppedResult.elapsed, std::chrono::milliseconds(1000));
+    EXPECT_NE(earlyStoppedResult.bestMove, PackedMove())
+        << "Something to play even without a completed iteration";
+
+    auto nextResult = searcher->search(*game, SearchLimits{ .depth = 3 });
+
+    EXPECT_GE(nextResult.depth, 3)
+        << "The stop does not carry over to the next search";
+}
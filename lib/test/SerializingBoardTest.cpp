@@ -22,3 +22,71 @@ TEST(SerializingBoardTest, SerializeFEN) {
 
     EXPECT_EQ(game->serializeAsFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR w - - 0 1");
 }
+
+TEST(SerializingBoardTest, SerializeParsedFEN) {
+    auto game = std::make_unique<Game>();
+
+    for (const auto* fen : {
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 5 17",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    }) {
+        game->parseFEN(fen);
+
+        EXPECT_EQ(game->serializeAsFEN(), fen);
+    }
+}
+
+TEST(SerializingBoardTest, SerializeAfterMoves) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 3 10");
+
+    game->applyMove(Move{ .piece = WHITE_ROOK, .from = Position{.row = 1, .col = 'h' }, .to = Position{.row = 1, .col = 'g' } });
+
+    EXPECT_EQ(game->serializeAsFEN(), "r3k2r/8/8/8/8/8/8/R3K1R1 b Qkq - 4 10")
+        << "Moving the rook loses its castling right";
+
+    game->applyMove(Move{ .piece = BLACK_KING, .from = Position{.row = 8, .col = 'e' }, .to = Position{.row = 8, .col = 'd' } });
+
+    EXPECT_EQ(game->serializeAsFEN(), "r2k3r/8/8/8/8/8/8/R3K1R1 w Q - 5 11")
+        << "Moving the king loses both of its castling rights, black's move bumps the fullmove number";
+
+    game->undoMove();
+
+    EXPECT_EQ(game->serializeAsFEN(), "r3k2r/8/8/8/8/8/8/R3K1R1 b Qkq - 4 10");
+}
+
+TEST(SerializingBoardTest, SerializeIntoBuffer) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+    char buffer[MAX_FEN_LENGTH];
+    auto length = game->serializeAsFEN(buffer);
+
+    EXPECT_EQ(std::string_view(buffer, length), "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+    char exact[61];
+
+    EXPECT_EQ(game->serializeAsFEN(exact), 61)
+        << "A buffer just as long as the FEN is enough";
+
+    char small[60];
+
+    EXPECT_EQ(game->serializeAsFEN(small), 0)
+        << "Nothing is written to a buffer too small for the FEN";
+}
+
+TEST(SerializingBoardTest, Formatter) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 5 17");
+
+    EXPECT_EQ(std::format("{}", *game), "r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 5 17");
+
+    std::string log;
+    std::format_to(std::back_inserter(log), "position: {}", *game);
+
+    EXPECT_EQ(log, "position: r3k2r/pp1b1ppp/nqp1pn2/2bp4/N1P1P3/1P1B1N2/PB1PQPPP/R3K2R b kq - 5 17");
+}
@@ -0,0 +1,170 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+TEST(SerializingMoveTest, SimpleMoves) {
+    auto game = std::make_unique<Game>();
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("e4")), "e4");
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Nf3")), "Nf3");
+}
+
+TEST(SerializingMoveTest, Disambiguation) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/R7/8/8/8/8/R3K3 w - - 0 1");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("R1a3")), "R1a3")
+        << "Rooks on the same file are told apart by the rank";
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Rb1")), "Rb1")
+        << "Only one rook can move to b1";
+
+    game->parseFEN("8/7k/8/8/Q5Q1/8/8/Q3K3 w - - 0 1");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Qa4d1")), "Qa4d1")
+        << "Queens sharing both the file and the rank with the moving one need the whole square";
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Qgd1")), "Qgd1")
+        << "The file is preferred over the rank";
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Nb1")), "Nb1")
+        << "Only legal moves count, the pinned knight on c3 does not need telling apart";
+}
+
+TEST(SerializingMoveTest, PawnMoves) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("dxc8=N")), "dxc8=N");
+    EXPECT_EQ(game->serializeMove(*game->parseMove("dxc8=Q")), "dxc8=Q")
+        << "The queen on d8 blocks the check along the rank";
+
+    game->parseFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("exf6")), "exf6")
+        << "En passant";
+}
+
+TEST(SerializingMoveTest, Castling) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("O-O")), "O-O");
+    EXPECT_EQ(game->serializeMove(*game->parseMove("O-O-O")), "O-O-O");
+}
+
+TEST(SerializingMoveTest, CheckAndMate) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r1bqkbnr/pppp1ppp/2n5/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 2 3");
+
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Qxf7")), "Qxf7#");
+    EXPECT_EQ(game->serializeMove(*game->parseMove("Bxf7")), "Bxf7+");
+}
+
+TEST(SerializingMoveTest, UCI) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+    char buffer[MAX_MOVE_LENGTH];
+
+    auto length = game->serializeMove(*game->parsePackedMove("dxc8=Q"), buffer, UCI_NOTATION);
+    EXPECT_EQ(std::string_view(buffer, length), "d7c8q");
+
+    length = game->serializeMove(*game->parsePackedMove("O-O"), buffer, UCI_NOTATION);
+    EXPECT_EQ(std::string_view(buffer, length), "e1g1");
+}
+
+TEST(SerializingMoveTest, IllegalMoveOrSmallBuffer) {
+    auto game = std::make_unique<Game>();
+
+    EXPECT_EQ(game->serializeMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 5, .col = 'e' } }), "");
+
+    char small[2];
+
+    EXPECT_EQ(game->serializeMove(*game->parsePackedMove("Nf3"), small), 0)
+        << "Nothing is written to a buffer too small for the move";
+}
+
+TEST(SerializingMoveTest, WholeGame) {
+    auto game = std::make_unique<Game>();
+
+    std::vector<Move> moves;
+    Game replay = *game;
+
+    for (const auto* notation : { "e4", "e5", "Bc4", "Nc6", "Qh5", "Nf6", "Qxf7#" }) {
+        auto move = replay.parseMove(notation);
+
+        ASSERT_NE(move, std::nullopt) << notation;
+
+        moves.push_back(*move);
+        replay.makeMove(*move);
+    }
+
+    char buffer[256];
+
+    auto san = game->serializeMoves(moves, buffer);
+
+    EXPECT_EQ(san.moves, moves.size());
+    EXPECT_EQ(std::string_view(buffer, san.written), "e4 e5 Bc4 Nc6 Qh5 Nf6 Qxf7#");
+
+    auto uci = game->serializeMoves(moves, buffer, UCI_NOTATION);
+
+    EXPECT_EQ(std::string_view(buffer, uci.written), "e2e4 e7e5 f1c4 b8c6 d1h5 g8f6 h5f7");
+
+    auto partial = game->serializeMoves(moves, std::span<char>(buffer, 10));
+
+    EXPECT_EQ(partial.moves, 3)
+        << "Only whole moves are written";
+    EXPECT_EQ(std::string_view(buffer, partial.written), "e4 e5 Bc4");
+}
+
+TEST(SerializingMoveTest, EveryMoveParsesBack) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        MoveList moves;
+        game->generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            char buffer[MAX_MOVE_LENGTH];
+            auto length = game->serializeMove(move, buffer);
+
+            ASSERT_GT(length, 0);
+
+            auto notation = std::string_view(buffer, length);
+
+            EXPECT_EQ(game->parsePackedMove(notation), move)
+                << position.name << ", " << notation;
+
+            Game next = *game;
+            next.makeMove(move);
+
+            EXPECT_EQ(game->givesCheck(move), next.isInCheck())
+                << position.name << ", " << notation;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+
+TEST(SquareTest, Size) {
+    EXPECT_EQ(sizeof(Square), 1);
+}
+
+TEST(SquareTest, FileAndRank) {
+    constexpr auto square = Square::fromFileRank(4, 3);
+
+    static_assert(square.index() == 28);
+    static_assert(square.file() == 4);
+    static_assert(square.rank() == 3);
+
+    EXPECT_EQ(square.toAlgebraic(), "e4");
+}
+
+TEST(SquareTest, FromAlgebraic) {
+    static_assert(Square::fromAlgebraic("a1") == Square(0));
+    static_assert(Square::fromAlgebraic("h8") == Square(63));
+
+    EXPECT_THAT(Square::fromAlgebraic("e4"), Optional(makeSquare(4, 'e')));
+
+    EXPECT_EQ(Square::fromAlgebraic("i4"), std::nullopt);
+    EXPECT_EQ(Square::fromAlgebraic("e9"), std::nullopt);
+    EXPECT_EQ(Square::fromAlgebraic("e"), std::nullopt);
+}
+
+TEST(SquareTest, PositionShim) {
+    auto position = Position{ .row = 7, .col = 'd' };
+
+    EXPECT_EQ(position.square(), Square::fromAlgebraic("d7"));
+    EXPECT_EQ(Position::fromSquare(position.square()), position);
+}
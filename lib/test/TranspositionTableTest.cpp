@@ -0,0 +1,176 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/TranspositionTable.hpp"
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+    auto table = std::make_unique<TranspositionTable>(1);
+    auto game = std::make_unique<Game>();
+
+    auto move = *game->parsePackedMove("e4");
+
+    TranspositionEntry entry;
+
+    EXPECT_FALSE(table->probe(game->hash(), entry));
+
+    table->store(game->hash(), move, -31990, 7, LOWER_BOUND);
+
+    ASSERT_TRUE(table->probe(game->hash(), entry));
+
+    EXPECT_EQ(entry.move, move);
+    EXPECT_EQ(entry.score, -31990);
+    EXPECT_EQ(entry.depth, 7);
+    EXPECT_EQ(entry.bound, LOWER_BOUND);
+
+    EXPECT_FALSE(table->probe(game->hash() ^ 1, entry))
+        << "A key sharing the bucket does not match";
+
+    EXPECT_FALSE(table->probe(0, entry))
+        << "Empty entries do not match the zero key";
+
+    table->clear();
+
+    EXPECT_FALSE(table->probe(game->hash(), entry));
+}
+
+TEST(TranspositionTableTest, Size) {
+    auto table = std::make_unique<TranspositionTable>(1);
+
+    EXPECT_EQ(table->size(), 1024 * 1024 / 16)
+        << "16-byte entries";
+
+    table->resize(3, true);
+
+    EXPECT_EQ(table->size(), 2 * 1024 * 1024 / 16)
+        << "Rounded down to a power of two";
+
+    table->store(42, PackedMove(), 0, 1, EXACT_BOUND);
+
+    TranspositionEntry entry;
+
+    EXPECT_TRUE(table->probe(42, entry))
+        << "Huge page backing or not, the table works the same";
+}
+
+TEST(TranspositionTableTest, Replacement) {
+    auto table = std::make_unique<TranspositionTable>(1);
+    auto game = std::make_unique<Game>();
+
+    auto move = *game->parsePackedMove("e4");
+    auto buckets = table->size() / TranspositionTable::BUCKET_SIZE;
+
+    TranspositionEntry entry;
+
+    table->store(1, move, 10, 10, EXACT_BOUND);
+    table->store(1, PackedMove(), 20, 4, UPPER_BOUND);
+
+    ASSERT_TRUE(table->probe(1, entry));
+    EXPECT_EQ(entry.depth, 10)
+        << "A much shallower bound does not push out a deeper result of the same search";
+
+    table->store(1, PackedMove(), 20, 9, UPPER_BOUND);
+
+    ASSERT_TRUE(table->probe(1, entry));
+    EXPECT_EQ(entry.depth, 9);
+    EXPECT_EQ(entry.move, move)
+        << "A result without a move keeps the one stored before";
+
+    // fill the bucket of key 1 with deeper entries, then one more
+    for (std::uint64_t i = 1; i < TranspositionTable::BUCKET_SIZE; ++i) {
+        table->store(1 + i * buckets, move, 0, 20, EXACT_BOUND);
+    }
+
+    table->store(1 + TranspositionTable::BUCKET_SIZE * buckets, move, 0, 20, EXACT_BOUND);
+
+    EXPECT_FALSE(table->probe(1, entry))
+        << "The shallowest entry of a full bucket goes";
+
+    // results two searches old count as eight plies shallower for every search since
+    table->clear();
+
+    for (std::uint64_t i = 0; i < TranspositionTable::BUCKET_SIZE; ++i) {
+        table->store(1 + i * buckets, move, 0, 20, EXACT_BOUND);
+    }
+
+    table->newSearch();
+    table->newSearch();
+
+    table->store(1 + 3 * buckets, move, 0, 5, EXACT_BOUND);
+    table->store(1 + 4 * buckets, move, 0, 5, EXACT_BOUND);
+
+    EXPECT_TRUE(table->probe(1 + 3 * buckets, entry))
+        << "A shallow result of the current search stays";
+    EXPECT_FALSE(table->probe(1, entry))
+        << "A deep result of an old search goes";
+}
+
+TEST(TranspositionTableTest, FillRate) {
+    auto table = std::make_unique<TranspositionTable>(1);
+
+    EXPECT_EQ(table->fillPermille(), 0);
+
+    for (std::uint64_t key = 0; key < 1000; ++key) {
+        table->store(key, PackedMove(), 0, 1, EXACT_BOUND);
+    }
+
+    EXPECT_EQ(table->fillPermille(), 250)
+        << "One entry in each of the sampled buckets";
+
+    table->newSearch();
+
+    EXPECT_EQ(table->fillPermille(), 0)
+        << "Only the current search counts";
+}
+
+TEST(TranspositionTableTest, ConcurrentAccess) {
+    auto table = std::make_unique<TranspositionTable>(1);
+
+    constexpr int THREADS = 4;
+    constexpr std::uint64_t KEYS = 1 << 16;
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(THREADS, 0);
+
+    // every thread writes its own score for the same keys and reads them back; a torn entry would mix two of them
+    for (int thread = 0; thread < THREADS; ++thread) {
+        threads.emplace_back([&table, &mismatches, thread]() {
+            for (int pass = 0; pass < 8; ++pass) {
+                for (std::uint64_t i = 0; i < KEYS; ++i) {
+                    auto key = i * 0x9E3779B97F4A7C15ULL;
+                    auto score = static_cast<int>(i % 1000) * THREADS + thread;
+
+                    table->store(key, PackedMove(), score, score % 64 + 1, EXACT_BOUND);
+
+                    TranspositionEntry entry;
+
+                    if (table->probe(key, entry) && (entry.score / THREADS != static_cast<int>(i % 1000) || entry.depth != entry.score % 64 + 1)) {
+                        ++mismatches[thread];
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+}
@@ -0,0 +1,133 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+namespace {
+    void expectSameState(const Game& actual, const Game& expected, const std::string& name) {
+        ASSERT_EQ(actual.board, expected.board) << name;
+        ASSERT_EQ(actual.pieceBitboards, expected.pieceBitboards) << name;
+        ASSERT_EQ(actual.colorBitboards, expected.colorBitboards) << name;
+        ASSERT_EQ(actual.occupied, expected.occupied) << name;
+        ASSERT_EQ(actual.currentPlayer, expected.currentPlayer) << name;
+        ASSERT_EQ(actual.serializeAsFEN(), expected.serializeAsFEN()) << name;
+        ASSERT_EQ(actual.halfmoveClock, expected.halfmoveClock) << name;
+        ASSERT_EQ(actual.hash(), expected.hash()) << name;
+        ASSERT_EQ(actual.pawnHash(), expected.pawnHash()) << name;
+        ASSERT_EQ(actual.moveHistory, expected.moveHistory) << name;
+    }
+
+    // every move of the tree is made and taken back, and the game has to be exactly as it was before
+    void expectUndoRestores(Game& game, int depth, const std::string& name) {
+        if (depth == 0) {
+            return;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            Game before = game;
+
+            game.makeMove(move);
+            expectUndoRestores(game, depth - 1, name);
+            game.undoMove();
+
+            expectSameState(game, before, name);
+        }
+    }
+}
+
+TEST(UndoMoveTest, RestoresEveryPosition) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        expectUndoRestores(*game, 3, position.name);
+    }
+}
+
+TEST(UndoMoveTest, Castling) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    game->makeMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'c' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true });
+    game->undoMove();
+
+    EXPECT_EQ(game->pieceAt(1, 'e'), WHITE_KING);
+    EXPECT_EQ(game->pieceAt(1, 'a'), WHITE_ROOK);
+    EXPECT_EQ(game->pieceAt(1, 'c'), NONE);
+    EXPECT_EQ(game->pieceAt(1, 'd'), NONE);
+
+    EXPECT_TRUE(game->castlingAvailability().WHITE_KING_SIDE);
+    EXPECT_TRUE(game->castlingAvailability().WHITE_QUEEN_SIDE);
+
+    EXPECT_EQ(game->currentPlayer, WHITE);
+}
+
+TEST(UndoMoveTest, EnPassant) {
+    auto game = std::make_unique<Game>();
+
+    game->applyMove(*game->parseMove("e4"));
+    game->applyMove(*game->parseMove("b6"));
+    game->applyMove(*game->parseMove("e5"));
+    game->applyMove(*game->parseMove("d5"));
+
+    game->makeMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 5, .col = 'e' }, .to = Position{.row = 6, .col = 'd' }, .promotion = std::nullopt, .isCapture = true, .isCastling = false });
+    game->undoMove();
+
+    EXPECT_EQ(game->pieceAt(5, 'e'), WHITE_PAWN);
+    EXPECT_EQ(game->pieceAt(5, 'd'), BLACK_PAWN);
+    EXPECT_EQ(game->pieceAt(6, 'd'), NONE);
+
+    EXPECT_EQ(game->enPassantSquare(), makeSquare(6, 'd'))
+        << "En passant is available again after taking the capture back";
+}
+
+TEST(UndoMoveTest, CapturingPromotion) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+    game->makeMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 7, .col = 'd' }, .to = Position{.row = 8, .col = 'c' }, .promotion = WHITE_QUEEN, .isCapture = true, .isCastling = false });
+
+    EXPECT_EQ(game->pieceAt(8, 'c'), WHITE_QUEEN);
+
+    game->undoMove();
+
+    EXPECT_EQ(game->pieceAt(7, 'd'), WHITE_PAWN);
+    EXPECT_EQ(game->pieceAt(8, 'c'), BLACK_BISHOP);
+}
+
+TEST(UndoMoveTest, HalfmoveClock) {
+    auto game = std::make_unique<Game>();
+
+    game->applyMove(*game->parseMove("Nf3"));
+    game->applyMove(*game->parseMove("Nf6"));
+
+    EXPECT_EQ(game->halfmoveClock, 2);
+
+    game->applyMove(*game->parseMove("e4"));
+
+    EXPECT_EQ(game->halfmoveClock, 0)
+        << "Pawn moves reset the clock";
+
+    game->undoMove();
+
+    EXPECT_EQ(game->halfmoveClock, 2);
+}
@@ -426,6 +426,41 @@ TEST(ApplyingMoveTest, PawnAdvancement) {
     // game->applyMove(game->parseMove("e4"));
     game->applyMove(Move{ .piece = WHITE_PAWN, .from = Position{.row = 2, .col = 'e' }, .to = Position{.row = 4, .col = 'e' } });
 
-    EXPECT_EQ(game->serializeAsFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b - - 0 1")
+    EXPECT_EQ(game->serializeAsFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b - e3 0 1")
         << "Serialized board after applying a e4 move";
 }
+
+TEST(ValidatingKingMoveTest, CanNotStepBackAlongCheckingRay) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/r3K3/8/8/8 w - - 0 1");
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = WHITE_KING, .from = Position{.row = 4, .col = 'e' }, .to = Position{.row = 4, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }))
+        << "Square behind the king on the rank of the checking rook is attacked too";
+
+    EXPECT_TRUE(game->isValidMove(Move{ .piece = WHITE_KING, .from = Position{.row = 4, .col = 'e' }, .to = Position{.row = 5, .col = 'f' }, .promotion = std::nullopt, .isCapture = false, .isCastling = false }));
+}
+
+TEST(ValidatingKingMoveTest, CastlingThroughAttackedSquare) {
+    auto game = std::make_unique<Game>();
+
+    game->parseFEN("4k3/8/8/8/8/8/5r2/4K2R w K - 0 1");
+
+    EXPECT_TRUE(game->canOpponentMoveTo(Position{ .row = 1, .col = 'f' }));
+    EXPECT_FALSE(game->canOpponentMoveTo(Position{ .row = 1, .col = 'h' }));
+
+    EXPECT_FALSE(game->isValidMove(Move{ .piece = WHITE_KING, .from = Position{.row = 1, .col = 'e' }, .to = Position{.row = 1, .col = 'g' }, .promotion = std::nullopt, .isCapture = false, .isCastling = true }))
+        << "King can not castle through the square attacked by the rook on f2";
+}
+
+TEST(ValidatingKingMoveTest, AttackedSquares) {
+    auto game = std::make_unique<Game>();
+
+    // after 1. e4, a pawn push does not attack the square in front of it
+    game->applyMove(*game->parseMove("e4"));
+
+    EXPECT_EQ(game->attackedSquares(WHITE) & squareBit(makeSquare(5, 'e')), EMPTY_BITBOARD);
+    EXPECT_NE(game->attackedSquares(WHITE) & squareBit(makeSquare(5, 'd')), EMPTY_BITBOARD);
+    EXPECT_NE(game->attackedSquares(WHITE) & squareBit(makeSquare(5, 'h')), EMPTY_BITBOARD)
+        << "Queen on d1 attacks h5 after the e-pawn has moved";
+}
@@ -0,0 +1,93 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::Optional;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Ne;
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+namespace {
+    // walks the whole move tree, comparing the incrementally updated keys against the ones computed from scratch
+    void expectHashesMatch(const Game& game, int depth, const std::string& name) {
+        ASSERT_EQ(game.hash(), game.computeHash()) << name;
+        ASSERT_EQ(game.pawnHash(), game.computePawnHash()) << name;
+
+        if (depth == 0) {
+            return;
+        }
+
+        MoveList moves;
+        game.generateLegalMoves(moves);
+
+        for (auto move : moves) {
+            Game next = game;
+            next.makeMove(move);
+
+            expectHashesMatch(next, depth - 1, name);
+        }
+    }
+}
+
+TEST(ZobristTest, IncrementalHashMatchesComputed) {
+    for (const auto& position : PERFT_POSITIONS) {
+        auto game = std::make_unique<Game>();
+
+        game->parseFEN(position.fen);
+
+        expectHashesMatch(*game, 3, position.name);
+    }
+}
+
+TEST(ZobristTest, StartPosition) {
+    auto game = std::make_unique<Game>();
+    auto other = std::make_unique<Game>();
+
+    other->parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1");
+
+    EXPECT_EQ(game->hash(), other->hash())
+        << "Default constructed game has no castling rights, same as the FEN";
+}
+
+TEST(ZobristTest, Transpositions) {
+    auto game = std::make_unique<Game>();
+    auto other = std::make_unique<Game>();
+
+    game->applyMove(*game->parseMove("Nf3"));
+    game->applyMove(*game->parseMove("Nf6"));
+    game->applyMove(*game->parseMove("e3"));
+
+    other->applyMove(*other->parseMove("e3"));
+    other->applyMove(*other->parseMove("Nf6"));
+    other->applyMove(*other->parseMove("Nf3"));
+
+    EXPECT_EQ(game->hash(), other->hash());
+    EXPECT_EQ(game->pawnHash(), other->pawnHash());
+}
+
+TEST(ZobristTest, SideToMoveAndEnPassant) {
+    auto game = std::make_unique<Game>();
+    auto other = std::make_unique<Game>();
+
+    game->parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR w - - 0 1");
+    other->parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b - - 0 1");
+
+    EXPECT_NE(game->hash(), other->hash());
+    EXPECT_EQ(game->pawnHash(), other->pawnHash());
+
+    auto afterPush = std::make_unique<Game>();
+
+    afterPush->applyMove(*afterPush->parseMove("e4"));
+
+    EXPECT_NE(afterPush->hash(), other->hash())
+        << "En passant square after a two-rank advancement is a part of the key";
+}
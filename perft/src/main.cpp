@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "chesslib/Game.hpp"
+#include "chesslib/Perft.hpp"
+
+void showHelp(char** argv) {
+    std::cout << "Usage: " << argv[0] << " [ARGS]\n\n";
+    std::cout << "Possible argument values:\n";
+    std::cout << "\t(--depth | -d) N - depth of the move tree to count, default: 5\n";
+    std::cout << "\t(--fen | -f) FEN - position to start from, default: the start position\n";
+    std::cout << "\t(--threads | -t) N - number of threads to count with, default: 1\n";
+    std::cout << "\t--split-depth N - number of plies the tree is split into tasks for when counting with threads, default: 2\n";
+    std::cout << "\t--hash MB - size of the table caching subtree counts, 0 disables it, default: 0\n";
+    std::cout << "\t(--suite | -s) - run the reference positions up to the given depth and compare against the known counts\n";
+    std::cout << "\t(--help | -h) - show this message\n\n";
+}
+
+std::string moveToString(const PackedMove move) {
+    constexpr char promotionSymbols[] = { 'p', 'n', 'b', 'r', 'q', 'k' };
+
+    std::string result = move.from().toAlgebraic() + move.to().toAlgebraic();
+
+    if (move.isPromotion()) {
+        result += promotionSymbols[move.promotionType()];
+    }
+
+    return result;
+}
+
+struct PerftResult {
+    std::uint64_t nodes;
+    double seconds;
+};
+
+struct PerftOptions {
+    int depth;
+    int splitDepth;
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<PerftTable> table;
+};
+
+PerftResult runDivide(const Game& game, const PerftOptions& options, int depth, bool printDivide) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto divide = options.pool ? perftDivide(game, depth, *options.pool, options.splitDepth, options.table.get()) : perftDivide(game, depth, options.table.get());
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t nodes = 0;
+
+    for (const auto& [move, moveNodes] : divide) {
+        if (printDivide) {
+            std::cout << std::format("{}: {}\n", moveToString(move), moveNodes);
+        }
+
+        nodes += moveNodes;
+    }
+
+    return PerftResult{ .nodes = nodes, .seconds = elapsed.count() };
+}
+
+void printHashStatistics(const PerftTable& table) {
+    auto rate = table.probes() > 0 ? 100.0 * table.hits() / table.probes() : 0.0;
+
+    std::cout << std::format("Hash hits: {} / {} probes ({:.1f}%)\n", table.hits(), table.probes(), rate);
+}
+
+void printSummary(const PerftResult& result, const PerftOptions& options) {
+    auto nodesPerSecond = result.seconds > 0 ? static_cast<std::uint64_t>(result.nodes / result.seconds) : 0;
+
+    std::cout << std::format("\nNodes: {}\nTime: {:.3f} s\nNodes/sec: {}\n", result.nodes, result.seconds, nodesPerSecond);
+
+    if (options.table) {
+        printHashStatistics(*options.table);
+    }
+}
+
+int runSuite(const PerftOptions& options) {
+    int failures = 0;
+
+    for (const auto& position : PERFT_POSITIONS) {
+        Game game;
+        game.parseFEN(position.fen);
+
+        for (int depth = 1; depth <= options.depth && depth <= static_cast<int>(position.nodes.size()); ++depth) {
+            auto expected = position.nodes[depth - 1];
+
+            if (expected == 0) {
+                continue;
+            }
+
+            // every count is measured from an empty table, otherwise the deeper runs would reuse the shallower ones
+            if (options.table) {
+                options.table->clear();
+            }
+
+            auto result = runDivide(game, options, depth, false);
+            auto nodesPerSecond = result.seconds > 0 ? static_cast<std::uint64_t>(result.nodes / result.seconds) : 0;
+            auto passed = result.nodes == expected;
+
+            std::cout << std::format("{:<16} depth {}: {:>12} (expected {:>12}) {:>9.3f} s {:>12} nodes/sec {}\n",
+                position.name, depth, result.nodes, expected, result.seconds, nodesPerSecond, passed ? "OK" : "FAIL");
+
+            if (!passed) {
+                ++failures;
+            }
+        }
+    }
+
+    if (options.table) {
+        printHashStatistics(*options.table);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int depth = 5;
+    int splitDepth = 2;
+    unsigned int threads = 1;
+    std::string fen = PERFT_POSITIONS[0].fen;
+    std::size_t hashMegabytes = 0;
+    bool suite = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if ((arg == "--depth" || arg == "-d") && i + 1 < argc) {
+            depth = std::stoi(argv[++i]);
+        }
+        else if ((arg == "--threads" || arg == "-t") && i + 1 < argc) {
+            threads = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--split-depth" && i + 1 < argc) {
+            splitDepth = std::stoi(argv[++i]);
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = static_cast<std::size_t>(std::stoul(argv[++i]));
+        }
+        else if ((arg == "--fen" || arg == "-f") && i + 1 < argc) {
+            fen = argv[++i];
+        }
+        else if (arg == "--suite" || arg == "-s") {
+            suite = true;
+        }
+        else if (arg == "--help" || arg == "-h") {
+            showHelp(argv);
+
+            return 0;
+        }
+        else {
+            showHelp(argv);
+
+            return 1;
+        }
+    }
+
+    if (depth < 1 || threads < 1 || splitDepth < 1) {
+        showHelp(argv);
+
+        return 1;
+    }
+
+    PerftOptions options{ .depth = depth, .splitDepth = splitDepth, .pool = nullptr, .table = nullptr };
+
+    if (threads > 1) {
+        options.pool = std::make_unique<ThreadPool>(threads);
+    }
+
+    if (hashMegabytes > 0) {
+        options.table = std::make_unique<PerftTable>(hashMegabytes);
+    }
+
+    if (suite) {
+        return runSuite(options);
+    }
+
+    Game game;
+
+    if (auto parsed = game.parseFEN(fen); !parsed.has_value()) {
+        std::cerr << std::format("Invalid FEN: {}\n", fenErrorMessage(parsed.error()));
+
+        return 1;
+    }
+
+    printSummary(runDivide(game, options, depth, true), options);
+
+    return 0;
+}
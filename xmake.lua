@@ -11,6 +11,16 @@ target("chesslib")
     add_headerfiles("lib/include/**/*.hpp")
     add_includedirs("lib/include", {public = true})
 
+target("perft")
+    set_kind("binary")
+    add_files("perft/src/*.cpp")
+    add_deps("chesslib")
+
+target("bench")
+    set_kind("binary")
+    add_files("bench/src/*.cpp")
+    add_deps("chesslib")
+
 for _, file in ipairs(os.files("lib/test/*Test.cpp")) do
     local name = path.basename(file)
     target(name)